@@ -0,0 +1,177 @@
+/**
+ * @file disp_buf.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "disp_buf.h"
+#include "disp_spi.h"
+#include "disp_driver.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "disp_buf"
+
+#define MAX_LINES       CONFIG_LVGL_TFT_DISPLAY_BUF_LINES
+#define MIN_LINES       10
+#define RESERVE         (CONFIG_LVGL_TFT_DISPLAY_BUF_RESERVE_KB * 1024)
+#define LINE_BYTES      (LV_HOR_RES_MAX * sizeof(lv_color_t))
+
+#if CONFIG_LVGL_TFT_DISPLAY_BUF_DOUBLE
+#define BUF_CNT         2
+#else
+#define BUF_CNT         1
+#endif
+
+#define CAPS_INTERNAL   MALLOC_CAP_DMA
+#define CAPS_PSRAM      (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+
+/* ili9488_flush() converts the colors into a DMA buffer of its own */
+#if !CONFIG_LVGL_TFT_DISPLAY_BUF_INTERNAL && CONFIG_LVGL_TFT_DISPLAY_CONTROLLER != TFT_CONTROLLER_ILI9488
+#define USE_BOUNCE      1
+#if CONFIG_LVGL_TFT_DISPLAY_BOUNCE_LINES < MAX_LINES
+#define BOUNCE_BYTES    (CONFIG_LVGL_TFT_DISPLAY_BOUNCE_LINES * LINE_BYTES)
+#else
+#define BOUNCE_BYTES    (MAX_LINES * LINE_BYTES)
+#endif
+#else
+#define USE_BOUNCE      0
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t internal_lines(void);
+static bool alloc_bufs(lv_color_t ** buf, uint32_t lines, uint32_t caps);
+#if USE_BOUNCE
+static bool alloc_bounce(void);
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Allocate the draw buffers and initialize `disp_buf` with them.
+ * Internal DMA capable RAM is used as long as the buffers fit next to the
+ * configured reserve; otherwise (or if configured) full size buffers go to
+ * PSRAM and are flushed through two small internal bounce buffers.
+ * @param disp_buf the LVGL buffer descriptor, must stay valid
+ * @return size of one draw buffer in pixels
+ */
+uint32_t disp_buf_init(lv_disp_buf_t * disp_buf)
+{
+    lv_color_t * buf[2] = {NULL, NULL};
+    uint32_t lines = internal_lines();
+    bool psram = false;
+
+#if CONFIG_LVGL_TFT_DISPLAY_BUF_PSRAM
+    psram = true;
+#elif CONFIG_LVGL_TFT_DISPLAY_BUF_AUTO
+    psram = lines < MAX_LINES && heap_caps_get_free_size(CAPS_PSRAM) > 0;
+#endif
+
+    if(psram) {
+        if(alloc_bufs(buf, MAX_LINES, CAPS_PSRAM)) {
+#if USE_BOUNCE
+            if(!alloc_bounce()) {
+                ESP_LOGW(TAG, "No memory for the bounce buffers");
+                heap_caps_free(buf[0]);
+                heap_caps_free(buf[1]);
+                psram = false;
+            }
+#endif
+        } else {
+            ESP_LOGW(TAG, "Not enough PSRAM for %d lines", MAX_LINES);
+            psram = false;
+        }
+    }
+
+    if(psram) {
+        lines = MAX_LINES;
+    } else {
+        /*Measured again, a failed PSRAM attempt can leave the heap changed*/
+        lines = internal_lines();
+        if(lines < MIN_LINES) {
+            ESP_LOGW(TAG, "Draw buffers cut into the %d KB reserve", CONFIG_LVGL_TFT_DISPLAY_BUF_RESERVE_KB);
+            lines = MIN_LINES;
+        }
+
+        /*The largest free block can shrink between measuring and allocating*/
+        while(!alloc_bufs(buf, lines, CAPS_INTERNAL)) {
+            assert(lines > 1);
+            lines = lines * 3 / 4;
+        }
+    }
+
+    uint32_t size = lines * LV_HOR_RES_MAX;
+    lv_disp_buf_init(disp_buf, buf[0], buf[1], size);
+
+    ESP_LOGI(TAG, "%d x %u lines (%u bytes) in %s", BUF_CNT, lines, (unsigned)(size * sizeof(lv_color_t)),
+             psram ? "PSRAM" : "internal RAM");
+#if USE_BOUNCE
+    if(psram) ESP_LOGI(TAG, "2 x %u bytes bounce buffers", (unsigned)BOUNCE_BYTES);
+#endif
+    ESP_LOGI(TAG, "Free internal RAM: %u (largest block %u), PSRAM: %u",
+             (unsigned)heap_caps_get_free_size(CAPS_INTERNAL),
+             (unsigned)heap_caps_get_largest_free_block(CAPS_INTERNAL),
+             (unsigned)heap_caps_get_free_size(CAPS_PSRAM));
+
+    return size;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Lines per buffer that fit in internal RAM while keeping the reserve free */
+static uint32_t internal_lines(void)
+{
+    size_t free = heap_caps_get_free_size(CAPS_INTERNAL);
+    size_t largest = heap_caps_get_largest_free_block(CAPS_INTERNAL);
+    size_t avail = free > RESERVE ? (free - RESERVE) / BUF_CNT : 0;
+
+    if(avail > largest) avail = largest;
+
+    uint32_t lines = avail / LINE_BYTES;
+    return lines > MAX_LINES ? MAX_LINES : lines;
+}
+
+/* All or nothing */
+static bool alloc_bufs(lv_color_t ** buf, uint32_t lines, uint32_t caps)
+{
+    for(int i = 0; i < BUF_CNT; i++) {
+        buf[i] = heap_caps_malloc(lines * LINE_BYTES, caps);
+        if(buf[i] == NULL) {
+            while(i--) {
+                heap_caps_free(buf[i]);
+                buf[i] = NULL;
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#if USE_BOUNCE
+static bool alloc_bounce(void)
+{
+    uint8_t * a = heap_caps_malloc(BOUNCE_BYTES, CAPS_INTERNAL);
+    uint8_t * b = heap_caps_malloc(BOUNCE_BYTES, CAPS_INTERNAL);
+
+    if(a == NULL || b == NULL) {
+        heap_caps_free(a);
+        heap_caps_free(b);
+        return false;
+    }
+
+    disp_spi_set_bounce_buffers(a, b, BOUNCE_BYTES);
+    return true;
+}
+#endif
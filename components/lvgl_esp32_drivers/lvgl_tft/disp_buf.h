@@ -0,0 +1,41 @@
+/**
+ * @file disp_buf.h
+ *
+ * Runtime allocation of the LVGL draw buffers, sized from free memory.
+ */
+
+#ifndef DISP_BUF_H
+#define DISP_BUF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+uint32_t disp_buf_init(lv_disp_buf_t * disp_buf);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*DISP_BUF_H*/
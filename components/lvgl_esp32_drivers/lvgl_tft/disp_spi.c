@@ -1,176 +1,653 @@
-/**
- * @file disp_spi.c
- *
- */
-
-/*********************
- *      INCLUDES
- *********************/
-#include "esp_system.h"
-#include "driver/gpio.h"
-#include "driver/spi_master.h"
-
-#include <string.h>
-
-#include <freertos/FreeRTOS.h>
-#include <freertos/semphr.h>
-#include <freertos/task.h>
-
-#include "lvgl/lvgl.h"
-
-#include "disp_spi.h"
-#include "disp_driver.h"
-
-/*********************
- *      DEFINES
- *********************/
- #if CONFIG_LVGL_TFT_DISPLAY_SPI_HSPI == 1
- #define TFT_SPI_HOST HSPI_HOST
- #else
- #define TFT_SPI_HOST VSPI_HOST
- #endif
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-/**********************
- *  STATIC PROTOTYPES
- **********************/
-static void IRAM_ATTR spi_ready (spi_transaction_t *trans);
-
-/**********************
- *  STATIC VARIABLES
- **********************/
-static spi_device_handle_t spi;
-static volatile bool spi_trans_in_progress;
-static volatile bool spi_color_sent;
-static transaction_cb_t chained_post_cb;
-
-/**********************
- *      MACROS
- **********************/
-
-/**********************
- *   GLOBAL FUNCTIONS
- **********************/
-void disp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg)
-{
-    chained_post_cb=devcfg->post_cb;
-    devcfg->post_cb=spi_ready;
-    esp_err_t ret=spi_bus_add_device(host, devcfg, &spi);
-    assert(ret==ESP_OK);
-}
-
-void disp_spi_add_device(spi_host_device_t host)
-{
-    spi_device_interface_config_t devcfg={
-#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_HX8357
-            .clock_speed_hz=26*1000*1000,           //Clock out at 26 MHz
-#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ST7789
-            .clock_speed_hz=24*1000*1000,           //Clock out at 24 MHz
-#else
-            .clock_speed_hz=40*1000*1000,           //Clock out at 40 MHz
-#endif
-
-#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ST7789
-            .mode=2,                                //SPI mode 2
-#else
-	    .mode=0,				    // SPI mode 0
-#endif
-	    .spics_io_num=DISP_SPI_CS,              //CS pin
-            .queue_size=1,
-            .pre_cb=NULL,
-            .post_cb=NULL,
-            .flags = SPI_DEVICE_HALFDUPLEX
-    };
-
-    disp_spi_add_device_config(host, &devcfg);
-}
-
-void disp_spi_init(void)
-{
-
-    esp_err_t ret;
-
-    spi_bus_config_t buscfg={
-            .miso_io_num=-1,
-            .mosi_io_num=DISP_SPI_MOSI,
-            .sclk_io_num=DISP_SPI_CLK,
-            .quadwp_io_num=-1,
-            .quadhd_io_num=-1,
-#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ILI9341
-            .max_transfer_sz = DISP_BUF_SIZE * 2,
-#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ST7789
-            .max_transfer_sz = DISP_BUF_SIZE * 2,
-#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ILI9488
-            .max_transfer_sz = DISP_BUF_SIZE * 3,
-#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_HX8357
-            .max_transfer_sz = DISP_BUF_SIZE * 2
-#endif
-    };
-
-    //Initialize the SPI bus
-    ret=spi_bus_initialize(TFT_SPI_HOST, &buscfg, 1);
-    assert(ret==ESP_OK);
-
-    //Attach the LCD to the SPI bus
-    disp_spi_add_device(TFT_SPI_HOST);
-}
-
-void disp_spi_send_data(uint8_t * data, uint16_t length)
-{
-    if (length == 0) return;           //no need to send anything
-
-    while(spi_trans_in_progress);
-
-    spi_transaction_t t = {
-        .length = length * 8, // transaction length is in bits
-        .tx_buffer = data
-    };
-
-    spi_trans_in_progress = true;
-    spi_color_sent = false;             //Mark the "lv_flush_ready" NOT needs to be called in "spi_ready"
-    spi_device_queue_trans(spi, &t, portMAX_DELAY);
-//	spi_transaction_t *ta = &t;
-//	spi_device_get_trans_result(spi,&ta, portMAX_DELAY);
-}
-
-void disp_spi_send_colors(uint8_t * data, uint16_t length)
-{
-    if (length == 0) {
-	return;
-    }
-
-    while(spi_trans_in_progress);
-
-    spi_transaction_t t = {
-        .length = length * 8, // transaction length is in bits
-        .tx_buffer = data
-    };
-    
-    spi_trans_in_progress = true;
-    spi_color_sent = true;              //Mark the "lv_flush_ready" needs to be called in "spi_ready"
-    spi_device_queue_trans(spi, &t, portMAX_DELAY);
-//	spi_transaction_t *ta = &t;
-//	spi_device_get_trans_result(spi,&ta, portMAX_DELAY);
-}
-
-
-bool disp_spi_is_busy(void)
-{
-    return spi_trans_in_progress;
-}
-
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-
-static void IRAM_ATTR spi_ready (spi_transaction_t *trans)
-{
-    spi_trans_in_progress = false;
-
-    lv_disp_t * disp = lv_refr_get_disp_refreshing();
-    if(spi_color_sent) lv_disp_flush_ready(&disp->driver);
-    if(chained_post_cb) chained_post_cb(trans);
-}
+/**
+ * @file disp_spi.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "esp_system.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "driver/spi_common.h"
+#include "soc/spi_periph.h"
+#include "soc/soc_memory_layout.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "lvgl/lvgl.h"
+
+#include "disp_spi.h"
+#include "disp_driver.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+ #if CONFIG_LVGL_TFT_DISPLAY_SPI_HSPI == 1
+ #define TFT_SPI_HOST HSPI_HOST
+ #else
+ #define TFT_SPI_HOST VSPI_HOST
+ #endif
+
+#define TAG "disp_spi"
+
+/* spi_transaction_t.user of bounce chunks, counted in bounce_done */
+#define BOUNCE_MORE     ((void *)1)     /*does not end the flush*/
+#define BOUNCE_LAST     ((void *)2)
+
+#define CHUNK_STACK_SIZE    2048
+
+#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_HX8357
+#define DEFAULT_CLOCK   (26*1000*1000)
+#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ST7789
+#define DEFAULT_CLOCK   (24*1000*1000)
+#else
+#define DEFAULT_CLOCK   (40*1000*1000)
+#endif
+
+/* Highest clock the SPI signals take through the GPIO matrix */
+#define GPIO_MATRIX_MAX_CLOCK   (40*1000*1000)
+
+#if DISP_SPI_HIGH_SPEED
+#define TEST_READ_CLOCK (4*1000*1000)   /*RAMRD is specified far slower than RAMWR*/
+#define TEST_COLS       32
+#define TEST_ROWS       8
+#define TEST_PX         (TEST_COLS * TEST_ROWS)
+#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ILI9488
+#define TEST_WR_BYTES   (TEST_PX * 3)   /*RGB666, as ili9488_flush() sends it*/
+#else
+#define TEST_WR_BYTES   (TEST_PX * 2)   /*RGB565*/
+#endif
+#define TEST_RD_BYTES   (TEST_PX * 3)   /*RAMRD returns 18 bit pixels*/
+
+#define CMD_CASET       0x2A
+#define CMD_RASET       0x2B
+#define CMD_RAMWR       0x2C
+#define CMD_RAMRD       0x2E
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void IRAM_ATTR spi_ready (spi_transaction_t *trans);
+static void send_bounced(const uint8_t * data, size_t length);
+static void bounce_queue(spi_transaction_t * t);
+static void bounce_wait(int keep);
+static void chunk_task(void * arg);
+#if DISP_SPI_HIGH_SPEED
+static void detach_device(void);
+static bool test_readback(uint8_t * ref_p, uint8_t * ref_n, uint8_t * pattern, uint8_t * rx);
+static bool test_clock(int clock, const uint8_t * ref_p, const uint8_t * ref_n, uint8_t * pattern, uint8_t * rx);
+static spi_device_handle_t test_add_device(int clock);
+static void test_write(spi_device_handle_t dev, const uint8_t * pattern);
+static void test_read(spi_device_handle_t dev, uint8_t * rx, uint8_t * out);
+static void test_cmd(spi_device_handle_t dev, uint8_t cmd, const uint8_t * data, size_t len);
+static void test_invert(uint8_t * buf, size_t len);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static spi_device_handle_t spi;
+static volatile bool spi_trans_in_progress;
+static volatile bool spi_color_sent;
+static spi_transaction_t spi_trans[2];      /*Read by the driver after queuing, so not on the stack*/
+static uint8_t * bounce_buf[2];
+static size_t bounce_size;
+static SemaphoreHandle_t bounce_done;      /*Given in spi_ready() for every finished bounce chunk*/
+static int bounce_pending;                  /*Bounce chunks queued and not taken from bounce_done yet*/
+static transaction_cb_t chained_post_cb;
+static disp_spi_flush_done_cb_t flush_done_cb;
+static uint32_t flush_count;
+static spi_host_device_t spi_host;
+static spi_device_interface_config_t spi_devcfg;    /*Kept to re-attach the display with another clock*/
+static bool bus_shared;
+static TaskHandle_t chunk_handle;
+static const uint8_t * chunk_data;
+static size_t chunk_len;
+#if DISP_SPI_HIGH_SPEED
+static spi_device_handle_t spi_test_rd;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void disp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg)
+{
+    chained_post_cb=devcfg->post_cb;
+    devcfg->post_cb=spi_ready;
+    esp_err_t ret=spi_bus_add_device(host, devcfg, &spi);
+    assert(ret==ESP_OK);
+
+    if(bounce_done == NULL) {
+        bounce_done = xSemaphoreCreateCounting(2, 0);
+        assert(bounce_done != NULL);
+    }
+
+    spi_host=host;
+    spi_devcfg=*devcfg;
+}
+
+void disp_spi_add_device(spi_host_device_t host)
+{
+    spi_device_interface_config_t devcfg={
+            .clock_speed_hz=DEFAULT_CLOCK,          //40 MHz, 26 MHz on HX8357, 24 MHz on ST7789
+
+#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ST7789
+            .mode=2,                                //SPI mode 2
+#else
+	    .mode=0,				    // SPI mode 0
+#endif
+	    .spics_io_num=DISP_SPI_CS,              //CS pin
+            .queue_size=2,                          //Two bounce buffers in flight
+            .pre_cb=NULL,
+            .post_cb=NULL,
+            .flags = SPI_DEVICE_HALFDUPLEX
+    };
+
+    disp_spi_add_device_config(host, &devcfg);
+}
+
+void disp_spi_init(void)
+{
+
+    esp_err_t ret;
+
+    spi_bus_config_t buscfg={
+            .miso_io_num=DISP_SPI_MISO,
+            .mosi_io_num=DISP_SPI_MOSI,
+            .sclk_io_num=DISP_SPI_CLK,
+            .quadwp_io_num=-1,
+            .quadhd_io_num=-1,
+#if CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ILI9341
+            .max_transfer_sz = DISP_BUF_SIZE * 2,
+#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ST7789
+            .max_transfer_sz = DISP_BUF_SIZE * 2,
+#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_ILI9488
+            .max_transfer_sz = DISP_BUF_SIZE * 3,
+#elif CONFIG_LVGL_TFT_DISPLAY_CONTROLLER == TFT_CONTROLLER_HX8357
+            .max_transfer_sz = DISP_BUF_SIZE * 2
+#endif
+    };
+
+    //Initialize the SPI bus
+    ret=spi_bus_initialize(TFT_SPI_HOST, &buscfg, 1);
+    assert(ret==ESP_OK);
+
+    //Attach the LCD to the SPI bus
+    disp_spi_add_device(TFT_SPI_HOST);
+}
+
+void disp_spi_send_data(uint8_t * data, uint16_t length)
+{
+    if (length == 0) return;           //no need to send anything
+
+    while(spi_trans_in_progress);
+
+    spi_trans[0] = (spi_transaction_t) {
+        .length = length * 8, // transaction length is in bits
+        .tx_buffer = data
+    };
+
+    spi_trans_in_progress = true;
+    spi_color_sent = false;             //Mark the "lv_flush_ready" NOT needs to be called in "spi_ready"
+    spi_device_queue_trans(spi, &spi_trans[0], portMAX_DELAY);
+}
+
+void disp_spi_send_colors(uint8_t * data, size_t length)
+{
+    if (length == 0) {
+	return;
+    }
+
+    while(spi_trans_in_progress);
+
+    flush_count++;
+
+    if(bounce_size && !esp_ptr_dma_capable(data)) {
+        send_bounced(data, length);
+        return;
+    }
+
+    if(bus_shared && length > DISP_SPI_CHUNK_SIZE) {
+        spi_trans_in_progress = true;
+        spi_color_sent = true;
+        chunk_data = data;
+        chunk_len = length;
+        xTaskNotifyGive(chunk_handle);
+        return;
+    }
+
+    spi_trans[0] = (spi_transaction_t) {
+        .length = length * 8, // transaction length is in bits
+        .tx_buffer = data
+    };
+
+    spi_trans_in_progress = true;
+    spi_color_sent = true;              //Mark the "lv_flush_ready" needs to be called in "spi_ready"
+    spi_device_queue_trans(spi, &spi_trans[0], portMAX_DELAY);
+}
+
+bool disp_spi_is_busy(void)
+{
+    return spi_trans_in_progress;
+}
+
+/**
+ * Register a hook that runs in the SPI ISR right before lv_disp_flush_ready()
+ * is called for a finished flush. The callback must be placed in IRAM.
+ * @param cb the callback or NULL to remove it
+ * @return the previously registered callback, to be called by the new one
+ */
+disp_spi_flush_done_cb_t disp_spi_set_flush_done_cb(disp_spi_flush_done_cb_t cb)
+{
+    disp_spi_flush_done_cb_t prev = flush_done_cb;
+    flush_done_cb = cb;
+    return prev;
+}
+
+/**
+ * Get the number of flushes started so far. Each one ends with one call of
+ * the flush done callback, in the same order.
+ * @return color transfers started with disp_spi_send_colors()
+ */
+uint32_t disp_spi_get_flush_count(void)
+{
+    return flush_count;
+}
+
+/**
+ * Mark the bus as shared with other devices (e.g. the touch controller).
+ * Color transfers are then split into DISP_SPI_CHUNK_SIZE chunks with only
+ * one chunk in flight, so a transaction of another device waits for one
+ * chunk at most instead of a whole flush. The chunks are queued by a task
+ * created on the calling core, it must preempt the task calling
+ * lv_task_handler() to keep the bus busy.
+ * @param task_priority priority of the task queuing the chunks
+ */
+void disp_spi_set_shared(UBaseType_t task_priority)
+{
+    if(DISP_SPI_CHUNK_SIZE == 0 || chunk_handle != NULL) return;
+
+    BaseType_t ret = xTaskCreatePinnedToCore(chunk_task, "disp_chunk", CHUNK_STACK_SIZE, NULL,
+            task_priority, &chunk_handle, xPortGetCoreID());
+    assert(ret == pdPASS);
+    bus_shared = true;
+
+    ESP_LOGI(TAG, "Shared bus, colors sent in %d byte chunks", DISP_SPI_CHUNK_SIZE);
+}
+
+/**
+ * Set the internal DMA capable buffers through which colors that are not
+ * DMA capable (e.g. in PSRAM) are sent. The copy into one buffer overlaps
+ * the transmission of the other.
+ * @param buf1 first buffer
+ * @param buf2 second buffer
+ * @param size size of each buffer in bytes, 0 to disable bouncing
+ */
+void disp_spi_set_bounce_buffers(uint8_t * buf1, uint8_t * buf2, size_t size)
+{
+    bounce_buf[0] = buf1;
+    bounce_buf[1] = buf2;
+    bounce_size = size;
+}
+
+/**
+ * Check whether MOSI, CLK (and MISO if used) of the bus and the display CS
+ * are the native IO-MUX pins of the host. Only then the display can be
+ * clocked above 40 MHz.
+ */
+bool disp_spi_is_iomux(void)
+{
+    return spicommon_bus_using_iomux(spi_host) &&
+           spi_devcfg.spics_io_num == spi_periph_signal[spi_host].spics0_iomux_pin;
+}
+
+/**
+ * Find the fastest clock at which the display memory reads back what was
+ * written and re-attach the display with it. A pattern is written with
+ * RAMWR at each candidate clock and read back with RAMRD at a low clock.
+ * Call after the controller is initialized and before LVGL starts flushing.
+ * Without a working read-back (SDO not connected) the clock is not changed.
+ * @return the clock in use [Hz]
+ */
+int disp_spi_select_clock(void)
+{
+#if DISP_SPI_HIGH_SPEED
+    static const int candidates[] = {
+        80*1000*1000, 40*1000*1000, 80*1000*1000/3, 20*1000*1000, 16*1000*1000, 10*1000*1000
+    };
+
+    bool iomux = disp_spi_is_iomux();
+    int max_clock = iomux ? candidates[0] : GPIO_MATRIX_MAX_CLOCK;
+    int clock = spi_devcfg.clock_speed_hz;
+
+    uint8_t * pattern = heap_caps_malloc(TEST_WR_BYTES, MALLOC_CAP_DMA);
+    uint8_t * rx = heap_caps_malloc((TEST_RD_BYTES + 1 + 3) & ~3, MALLOC_CAP_DMA);
+    uint8_t * ref = malloc(TEST_RD_BYTES * 2);
+    if(pattern == NULL || rx == NULL || ref == NULL) {
+        ESP_LOGE(TAG, "Clock self-test: out of memory");
+        goto out;
+    }
+
+    detach_device();
+
+    /*CS is driven by hand so that one selection spans command and data phases*/
+    gpio_pad_select_gpio(spi_devcfg.spics_io_num);
+    gpio_set_direction(spi_devcfg.spics_io_num, GPIO_MODE_OUTPUT);
+    gpio_set_level(spi_devcfg.spics_io_num, 1);
+
+    spi_test_rd = test_add_device(TEST_READ_CLOCK);
+
+    if(!test_readback(ref, ref + TEST_RD_BYTES, pattern, rx)) {
+        ESP_LOGW(TAG, "Clock self-test: no usable read-back (MISO %d), keeping %d kHz",
+                 DISP_SPI_MISO, clock / 1000);
+    } else {
+        int i;
+        for(i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+            if(candidates[i] > max_clock) continue;
+            if(test_clock(candidates[i], ref, ref + TEST_RD_BYTES, pattern, rx)) break;
+            ESP_LOGW(TAG, "Clock self-test: %d kHz failed", candidates[i] / 1000);
+        }
+
+        if(i < sizeof(candidates) / sizeof(candidates[0])) {
+            clock = candidates[i];
+        } else {
+            ESP_LOGE(TAG, "Clock self-test: no clock passed, keeping %d kHz", clock / 1000);
+        }
+    }
+
+    spi_bus_remove_device(spi_test_rd);
+    spi_test_rd = NULL;
+
+    spi_devcfg.clock_speed_hz = clock;
+    esp_err_t ret = spi_bus_add_device(spi_host, &spi_devcfg, &spi);
+    assert(ret == ESP_OK);
+
+    ESP_LOGI(TAG, "SPI clock %d kHz (%s)", clock / 1000, iomux ? "IO-MUX" : "GPIO matrix");
+
+out:
+    heap_caps_free(pattern);
+    heap_caps_free(rx);
+    free(ref);
+#endif
+    return spi_devcfg.clock_speed_hz;
+}
+
+/**
+ * @return the clock of the display device [Hz]
+ */
+int disp_spi_get_clock(void)
+{
+    return spi_devcfg.clock_speed_hz;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Send colors in chunks through the bounce buffers. Returns once the last chunk is queued. */
+static void send_bounced(const uint8_t * data, size_t length)
+{
+    size_t sent = 0;
+    int i = 0;
+
+    /*The last chunks of the previous flush are done, take their results*/
+    bounce_wait(0);
+
+    spi_trans_in_progress = true;
+    spi_color_sent = true;
+
+    while(sent < length) {
+        /*Both buffers in flight: wait for the older one, it is bounce_buf[i]*/
+        bounce_wait(1);
+
+        size_t n = length - sent;
+        if(n > bounce_size) n = bounce_size;
+        memcpy(bounce_buf[i], data + sent, n);
+        sent += n;
+
+        /*On a shared bus the other devices get their turn between two chunks*/
+        if(bus_shared) bounce_wait(0);
+
+        spi_trans[i] = (spi_transaction_t) {
+            .length = n * 8,
+            .tx_buffer = bounce_buf[i],
+            .user = sent < length ? BOUNCE_MORE : BOUNCE_LAST
+        };
+        bounce_queue(&spi_trans[i]);
+
+        i ^= 1;
+    }
+}
+
+/* Queue a bounce chunk. Counted first, the chunk may be done before the queuing returns. */
+static void bounce_queue(spi_transaction_t * t)
+{
+    bounce_pending++;
+    spi_device_queue_trans(spi, t, portMAX_DELAY);
+}
+
+/* Wait until at most `keep` bounce chunks are in flight. The results of the
+ * driver's queue are not used: spi_ready() runs before the driver posts the
+ * result, so a finished chunk could be missing there. */
+static void bounce_wait(int keep)
+{
+    while(bounce_pending > keep) {
+        xSemaphoreTake(bounce_done, portMAX_DELAY);
+        bounce_pending--;
+    }
+}
+
+/* Queue the chunks of a color transfer one after the other. Transactions of
+ * other devices queued meanwhile are served as soon as the chunk is done. */
+static void chunk_task(void * arg)
+{
+    while(1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /*The last chunk of the previous flush is done, take its result*/
+        bounce_wait(0);
+
+        size_t sent = 0;
+        while(sent < chunk_len) {
+            size_t n = chunk_len - sent;
+            if(n > DISP_SPI_CHUNK_SIZE) n = DISP_SPI_CHUNK_SIZE;
+
+            spi_trans[0] = (spi_transaction_t) {
+                .length = n * 8,
+                .tx_buffer = chunk_data + sent,
+                .user = sent + n < chunk_len ? BOUNCE_MORE : BOUNCE_LAST
+            };
+            sent += n;
+            bounce_queue(&spi_trans[0]);
+
+            /*The last chunk ends the flush in spi_ready(), like a single transaction*/
+            if(sent < chunk_len) bounce_wait(0);
+        }
+    }
+}
+
+#if DISP_SPI_HIGH_SPEED
+/* Remove the display device once its last transaction is done */
+static void detach_device(void)
+{
+    spi_transaction_t * done;
+
+    while(spi_trans_in_progress);
+
+    /*Results are never collected while flushing but removal requires an empty queue*/
+    while(spi_device_get_trans_result(spi, &done, 0) == ESP_OK);
+
+    esp_err_t ret = spi_bus_remove_device(spi);
+    assert(ret == ESP_OK);
+    spi = NULL;
+}
+
+/* Reference read-back at the low clock. It has to be stable and has to follow the written data. */
+static bool test_readback(uint8_t * ref_p, uint8_t * ref_n, uint8_t * pattern, uint8_t * rx)
+{
+    uint32_t x = 0x2545F491;
+    for(int i = 0; i < TEST_WR_BYTES; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        pattern[i] = x;
+    }
+
+    test_write(spi_test_rd, pattern);
+    test_read(spi_test_rd, rx, ref_p);
+    test_read(spi_test_rd, rx, ref_n);
+    if(memcmp(ref_p, ref_n, TEST_RD_BYTES) != 0) return false;
+
+    test_invert(pattern, TEST_WR_BYTES);
+    test_write(spi_test_rd, pattern);
+    test_read(spi_test_rd, rx, ref_n);
+    test_invert(pattern, TEST_WR_BYTES);
+
+    /*A floating or unconnected MISO reads the same for both patterns*/
+    int changed = 0;
+    for(int i = 0; i < TEST_RD_BYTES; i++) {
+        if(ref_p[i] != ref_n[i]) changed++;
+    }
+
+    return changed > TEST_RD_BYTES / 2;
+}
+
+/* Write the pattern and its inverse at `clock` and compare their read-back with the references */
+static bool test_clock(int clock, const uint8_t * ref_p, const uint8_t * ref_n, uint8_t * pattern, uint8_t * rx)
+{
+    spi_device_handle_t dev = test_add_device(clock);
+    bool pass;
+
+    test_write(dev, pattern);
+    test_read(spi_test_rd, rx, NULL);
+    pass = memcmp(rx + 1, ref_p, TEST_RD_BYTES) == 0;
+
+    if(pass) {
+        test_invert(pattern, TEST_WR_BYTES);
+        test_write(dev, pattern);
+        test_read(spi_test_rd, rx, NULL);
+        test_invert(pattern, TEST_WR_BYTES);
+        pass = memcmp(rx + 1, ref_n, TEST_RD_BYTES) == 0;
+    }
+
+    spi_bus_remove_device(dev);
+    return pass;
+}
+
+static spi_device_handle_t test_add_device(int clock)
+{
+    spi_device_interface_config_t devcfg = spi_devcfg;
+    devcfg.clock_speed_hz = clock;
+    devcfg.spics_io_num = -1;
+    devcfg.queue_size = 1;
+    devcfg.pre_cb = NULL;
+    devcfg.post_cb = NULL;
+    devcfg.flags = SPI_DEVICE_HALFDUPLEX;
+
+    spi_device_handle_t dev;
+    esp_err_t ret = spi_bus_add_device(spi_host, &devcfg, &dev);
+    assert(ret == ESP_OK);
+    return dev;
+}
+
+static void test_write(spi_device_handle_t dev, const uint8_t * pattern)
+{
+    static const uint8_t cols[] = {0, 0, 0, TEST_COLS - 1};
+    static const uint8_t rows[] = {0, 0, 0, TEST_ROWS - 1};
+
+    test_cmd(dev, CMD_CASET, cols, sizeof(cols));
+    test_cmd(dev, CMD_RASET, rows, sizeof(rows));
+    test_cmd(dev, CMD_RAMWR, pattern, TEST_WR_BYTES);
+}
+
+/* RAMRD into rx (dummy byte first), copied to out without the dummy byte if out is not NULL */
+static void test_read(spi_device_handle_t dev, uint8_t * rx, uint8_t * out)
+{
+    test_cmd(dev, CMD_RAMRD, NULL, 0);
+
+    spi_transaction_t t = {
+        .rxlength = (TEST_RD_BYTES + 1) * 8,
+        .rx_buffer = rx
+    };
+
+    /*test_cmd() left CS low for the data phase*/
+    gpio_set_level(DISP_SPI_DC, 1);
+    spi_device_transmit(dev, &t);
+    gpio_set_level(spi_devcfg.spics_io_num, 1);
+
+    if(out) memcpy(out, rx + 1, TEST_RD_BYTES);
+}
+
+/* Send a command and its parameters. CS stays low after a command without parameters. */
+static void test_cmd(spi_device_handle_t dev, uint8_t cmd, const uint8_t * data, size_t len)
+{
+    spi_transaction_t t = {
+        .flags = SPI_TRANS_USE_TXDATA,
+        .length = 8,
+        .tx_data = {cmd}
+    };
+
+    gpio_set_level(spi_devcfg.spics_io_num, 0);
+    gpio_set_level(DISP_SPI_DC, 0);
+    spi_device_transmit(dev, &t);
+
+    if(data == NULL) return;
+
+    /*Short parameters go in tx_data, they may live in flash which DMA cannot read*/
+    t.length = len * 8;
+    if(len <= sizeof(t.tx_data)) {
+        memcpy(t.tx_data, data, len);
+    } else {
+        t.flags = 0;
+        t.tx_buffer = data;
+    }
+    gpio_set_level(DISP_SPI_DC, 1);
+    spi_device_transmit(dev, &t);
+    gpio_set_level(spi_devcfg.spics_io_num, 1);
+}
+
+static void test_invert(uint8_t * buf, size_t len)
+{
+    for(size_t i = 0; i < len; i++) buf[i] = ~buf[i];
+}
+#endif
+
+static void IRAM_ATTR spi_ready (spi_transaction_t *trans)
+{
+    if(trans->user == BOUNCE_MORE || trans->user == BOUNCE_LAST) {
+        BaseType_t woken = pdFALSE;
+        xSemaphoreGiveFromISR(bounce_done, &woken);
+        if(woken) portYIELD_FROM_ISR();
+    }
+
+    if(trans->user == BOUNCE_MORE) {
+        if(chained_post_cb) chained_post_cb(trans);
+        return;
+    }
+
+    spi_trans_in_progress = false;
+
+    lv_disp_t * disp = lv_refr_get_disp_refreshing();
+    if(spi_color_sent) {
+        if(flush_done_cb) flush_done_cb();
+        lv_disp_flush_ready(&disp->driver);
+    }
+    if(chained_post_cb) chained_post_cb(trans);
+}
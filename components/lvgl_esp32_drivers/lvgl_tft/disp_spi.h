@@ -1,52 +1,70 @@
-/**
- * @file disp_spi.h
- *
- */
-
-#ifndef DISP_SPI_H
-#define DISP_SPI_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*********************
- *      INCLUDES
- *********************/
-#include <stdint.h>
-#include <stdbool.h>
-#include <driver/spi_master.h>
-
-/*********************
- *      DEFINES
- *********************/
-
-#define DISP_SPI_MOSI CONFIG_LVGL_DISP_SPI_MOSI
-#define DISP_SPI_CLK CONFIG_LVGL_DISP_SPI_CLK
-#define DISP_SPI_CS CONFIG_LVGL_DISP_SPI_CS
-
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-/**********************
- * GLOBAL PROTOTYPES
- **********************/
-void disp_spi_init(void);
-void disp_spi_add_device(spi_host_device_t host);
-void disp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg);
-void disp_spi_send_data(uint8_t * data, uint16_t length);
-void disp_spi_send_colors(uint8_t * data, uint16_t length);
-bool disp_spi_is_busy(void);
-
-/**********************
- *      MACROS
- **********************/
-
-
-#ifdef __cplusplus
-} /* extern "C" */
-#endif
-
-#endif /*DISP_SPI_H*/
+/**
+ * @file disp_spi.h
+ *
+ */
+
+#ifndef DISP_SPI_H
+#define DISP_SPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <freertos/FreeRTOS.h>
+#include <driver/spi_master.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define DISP_SPI_MOSI CONFIG_LVGL_DISP_SPI_MOSI
+#define DISP_SPI_CLK CONFIG_LVGL_DISP_SPI_CLK
+#define DISP_SPI_CS CONFIG_LVGL_DISP_SPI_CS
+#define DISP_SPI_MISO CONFIG_LVGL_DISP_SPI_MISO
+#define DISP_SPI_DC CONFIG_LVGL_DISP_PIN_DC
+
+#define DISP_SPI_HIGH_SPEED CONFIG_LVGL_TFT_DISPLAY_SPI_HIGH_SPEED
+
+/* Color transfers on a shared bus are split into chunks of this size [bytes] */
+#define DISP_SPI_CHUNK_SIZE (CONFIG_LVGL_TFT_DISPLAY_SPI_CHUNK_KB * 1024)
+
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Called from the SPI ISR when the color transaction of a flush completes */
+typedef void (*disp_spi_flush_done_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void disp_spi_init(void);
+void disp_spi_add_device(spi_host_device_t host);
+void disp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg);
+void disp_spi_send_data(uint8_t * data, uint16_t length);
+void disp_spi_send_colors(uint8_t * data, size_t length);
+bool disp_spi_is_busy(void);
+disp_spi_flush_done_cb_t disp_spi_set_flush_done_cb(disp_spi_flush_done_cb_t cb);
+uint32_t disp_spi_get_flush_count(void);
+void disp_spi_set_shared(UBaseType_t task_priority);
+void disp_spi_set_bounce_buffers(uint8_t * buf1, uint8_t * buf2, size_t size);
+bool disp_spi_is_iomux(void);
+int disp_spi_select_clock(void);
+int disp_spi_get_clock(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*DISP_SPI_H*/
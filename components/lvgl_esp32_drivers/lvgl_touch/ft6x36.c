@@ -1,189 +1,349 @@
-/*
-* Copyright © 2020 Wolfgang Christl
-
-* Permission is hereby granted, free of charge, to any person obtaining a copy of this 
-* software and associated documentation files (the “Software”), to deal in the Software 
-* without restriction, including without limitation the rights to use, copy, modify, merge, 
-* publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons 
-* to whom the Software is furnished to do so, subject to the following conditions:
-*
-* The above copyright notice and this permission notice shall be included in all copies or 
-* substantial portions of the Software.
-* 
-* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
-* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
-* PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
-* FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
-* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
-* SOFTWARE.
-*/
-
-#include <esp_log.h>
-#include <driver/i2c.h>
-#include <lvgl/lvgl.h>
-#include "ft6x36.h"
-#include "tp_i2c.h"
-
-#define TAG "FT6X36"
-
-
-ft6x36_status_t ft6x36_status;
-uint8_t current_dev_addr;       // set during init
-
-esp_err_t ft6x06_i2c_read8(uint8_t slave_addr, uint8_t register_addr, uint8_t *data_buf) {
-    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, register_addr, I2C_MASTER_ACK);
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_READ, true);
-
-    i2c_master_read_byte(i2c_cmd, data_buf, I2C_MASTER_NACK);
-    i2c_master_stop(i2c_cmd);
-    esp_err_t ret = i2c_master_cmd_begin(I2C_NUM_0, i2c_cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(i2c_cmd);
-    return ret;
-}
-
-/**
-  * @brief  Read the FT6x36 gesture ID. Initialize first!
-  * @param  dev_addr: I2C FT6x36 Slave address.
-  * @retval The gesture ID or 0x00 in case of failure
-  */
-uint8_t ft6x36_get_gesture_id() {
-    if (!ft6x36_status.inited) {
-        ESP_LOGE(TAG, "Init first!");
-        return 0x00;
-    }
-    uint8_t data_buf;
-    esp_err_t ret;
-    if ((ret = ft6x06_i2c_read8(current_dev_addr, FT6X36_GEST_ID_REG, &data_buf) != ESP_OK))
-        ESP_LOGE(TAG, "Error reading from device: %s", esp_err_to_name(ret));
-    return data_buf;
-}
-
-/**
-  * @brief  Initialize for FT6x36 communication via I2C
-  * @param  dev_addr: Device address on communication Bus (I2C slave address of FT6X36).
-  * @retval None
-  */
-void ft6x06_init(uint16_t dev_addr) {
-    if (!ft6x36_status.inited) {
-        esp_err_t code = i2c_master_init();
-        if (code != ESP_OK) {
-            ft6x36_status.inited = false;
-            ESP_LOGE(TAG, "Error during I2C init %s", esp_err_to_name(code));
-        } else {
-            ft6x36_status.inited = true;
-            current_dev_addr = dev_addr;
-            uint8_t data_buf;
-            esp_err_t ret;
-            ESP_LOGI(TAG, "Found touch panel controller");
-            if ((ret = ft6x06_i2c_read8(dev_addr, FT6X36_PANEL_ID_REG, &data_buf) != ESP_OK))
-                ESP_LOGE(TAG, "Error reading from device: %s",
-                         esp_err_to_name(ret));    // Only show error the first time
-            ESP_LOGI(TAG, "\tDevice ID: 0x%02x", data_buf);
-
-            ft6x06_i2c_read8(dev_addr, FT6X36_CHIPSELECT_REG, &data_buf);
-            ESP_LOGI(TAG, "\tChip ID: 0x%02x", data_buf);
-
-            ft6x06_i2c_read8(dev_addr, FT6X36_DEV_MODE_REG, &data_buf);
-            ESP_LOGI(TAG, "\tDevice mode: 0x%02x", data_buf);
-
-            ft6x06_i2c_read8(dev_addr, FT6X36_FIRMWARE_ID_REG, &data_buf);
-            ESP_LOGI(TAG, "\tFirmware ID: 0x%02x", data_buf);
-
-            ft6x06_i2c_read8(dev_addr, FT6X36_RELEASECODE_REG, &data_buf);
-            ESP_LOGI(TAG, "\tRelease code: 0x%02x", data_buf);
-        }
-    }
-}
-
-/**
-  * @brief  Get the touch screen X and Y positions values. Ignores multi touch
-  * @param  drv:
-  * @param  data: Store data here
-  * @retval Always false
-  */
-bool ft6x36_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
-    uint8_t data_xy[4];        // 2 bytes X | 2 bytes Y
-    uint8_t touch_pnt_cnt;        // Number of detected touch points
-    static int16_t last_x = 0;  // 12bit pixel value
-    static int16_t last_y = 0;  // 12bit pixel value
-
-    ft6x06_i2c_read8(current_dev_addr, FT6X36_TD_STAT_REG, &touch_pnt_cnt);
-    if (touch_pnt_cnt != 1) {    // ignore no touch & multi touch
-        data->point.x = last_x;
-        data->point.y = last_y;
-        data->state = LV_INDEV_STATE_REL;
-        return false;
-    }
-
-    // Read X value
-    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, FT6X36_P1_XH_REG, I2C_MASTER_ACK);
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_READ, true);
-
-    i2c_master_read_byte(i2c_cmd, &data_xy[0], I2C_MASTER_ACK);     // reads FT6X36_P1_XH_REG
-    i2c_master_read_byte(i2c_cmd, &data_xy[1], I2C_MASTER_NACK);    // reads FT6X36_P1_XL_REG
-    i2c_master_stop(i2c_cmd);
-    esp_err_t ret = i2c_master_cmd_begin(I2C_NUM_0, i2c_cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(i2c_cmd);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Error getting X coordinates: %s", esp_err_to_name(ret));
-        data->point.x = last_x;
-        data->point.y = last_y;
-        data->state = LV_INDEV_STATE_REL;   // no touch detected
-        return false;
-    }
-
-    // Read Y value
-    i2c_cmd = i2c_cmd_link_create();
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_WRITE, true);
-    i2c_master_write_byte(i2c_cmd, FT6X36_P1_YH_REG, I2C_MASTER_ACK);
-
-    i2c_master_start(i2c_cmd);
-    i2c_master_write_byte(i2c_cmd, (current_dev_addr << 1) | I2C_MASTER_READ, true);
-
-    i2c_master_read_byte(i2c_cmd, &data_xy[2], I2C_MASTER_ACK);     // reads FT6X36_P1_YH_REG
-    i2c_master_read_byte(i2c_cmd, &data_xy[3], I2C_MASTER_NACK);    // reads FT6X36_P1_YL_REG
-    i2c_master_stop(i2c_cmd);
-    ret = i2c_master_cmd_begin(I2C_NUM_0, i2c_cmd, 1000 / portTICK_RATE_MS);
-    i2c_cmd_link_delete(i2c_cmd);
-    if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Error getting Y coordinates: %s", esp_err_to_name(ret));
-        data->point.x = last_x;
-        data->point.y = last_y;
-        data->state = LV_INDEV_STATE_REL;   // no touch detected
-        return false;
-    }
-
-    last_x = ((data_xy[0] & FT6X36_MSB_MASK) << 8) | (data_xy[1] & FT6X36_LSB_MASK);
-    last_y = ((data_xy[2] & FT6X36_MSB_MASK) << 8) | (data_xy[3] & FT6X36_LSB_MASK);
-
-#if CONFIG_LVGL_FT6X36_SWAPXY
-    int16_t swap_buf = last_x;
-    last_x = last_y;
-    last_y = swap_buf;
-#endif
-#if CONFIG_LVGL_FT6X36_INVERT_X
-    last_x =  LV_HOR_RES - last_x;
-#endif
-#if CONFIG_LVGL_FT6X36_INVERT_Y
-    last_y = LV_VER_RES - last_y;
-#endif
-    data->point.x = last_x;
-    data->point.y = last_y;
-    data->state = LV_INDEV_STATE_PR;
-    ESP_LOGV(TAG, "X=%u Y=%u", data->point.x, data->point.y);
-    return false;
-}
+/*
+* Copyright © 2020 Wolfgang Christl
+
+* Permission is hereby granted, free of charge, to any person obtaining a copy of this 
+* software and associated documentation files (the “Software”), to deal in the Software 
+* without restriction, including without limitation the rights to use, copy, modify, merge, 
+* publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons 
+* to whom the Software is furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all copies or 
+* substantial portions of the Software.
+* 
+* THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, 
+* INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR 
+* PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE 
+* FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, 
+* ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE 
+* SOFTWARE.
+*/
+
+#include <esp_log.h>
+#include <esp_attr.h>
+#include <driver/i2c.h>
+#include <driver/gpio.h>
+#include <lvgl/lvgl.h>
+#include "ft6x36.h"
+#include "tp_i2c.h"
+#include "touch_filter.h"
+
+#define TAG "FT6X36"
+
+
+ft6x36_status_t ft6x36_status;
+uint8_t current_dev_addr;       // set during init
+static touch_filter_t filter;
+static ft6x36_touches_t touches;    // points of the last read
+static uint8_t primary_id;          // touch reported to LVGL
+static bool primary_down;           // primary_id was reported pressed
+#if FT6X36_INT_MODE
+static volatile bool int_pending = true;   // read once at start in case the panel is touched
+static bool touch_active;
+#endif
+#if FT6X36_GESTURES
+static uint8_t last_gesture;
+static uint8_t new_gesture;         // recognized, not yet taken
+#endif
+
+esp_err_t ft6x06_i2c_read8(uint8_t slave_addr, uint8_t register_addr, uint8_t *data_buf) {
+    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
+
+    i2c_master_start(i2c_cmd);
+    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(i2c_cmd, register_addr, I2C_MASTER_ACK);
+
+    i2c_master_start(i2c_cmd);
+    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_READ, true);
+
+    i2c_master_read_byte(i2c_cmd, data_buf, I2C_MASTER_NACK);
+    i2c_master_stop(i2c_cmd);
+    esp_err_t ret = i2c_master_cmd_begin(I2C_NUM_0, i2c_cmd, 1000 / portTICK_RATE_MS);
+    i2c_cmd_link_delete(i2c_cmd);
+    return ret;
+}
+
+/**
+  * @brief  Read consecutive registers in one I2C transaction
+  * @param  slave_addr: I2C FT6x36 Slave address.
+  * @param  register_addr: first register
+  * @param  data_buf: store the register values here
+  * @param  len: number of registers
+  * @retval ESP32 error code
+  */
+esp_err_t ft6x36_i2c_read(uint8_t slave_addr, uint8_t register_addr, uint8_t *data_buf, size_t len) {
+    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
+
+    i2c_master_start(i2c_cmd);
+    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(i2c_cmd, register_addr, I2C_MASTER_ACK);
+
+    i2c_master_start(i2c_cmd);
+    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_READ, true);
+
+    i2c_master_read(i2c_cmd, data_buf, len, I2C_MASTER_LAST_NACK);
+    i2c_master_stop(i2c_cmd);
+    esp_err_t ret = i2c_master_cmd_begin(I2C_NUM_0, i2c_cmd, 1000 / portTICK_RATE_MS);
+    i2c_cmd_link_delete(i2c_cmd);
+    return ret;
+}
+
+static esp_err_t ft6x36_i2c_write8(uint8_t slave_addr, uint8_t register_addr, uint8_t data) {
+    i2c_cmd_handle_t i2c_cmd = i2c_cmd_link_create();
+
+    i2c_master_start(i2c_cmd);
+    i2c_master_write_byte(i2c_cmd, (slave_addr << 1) | I2C_MASTER_WRITE, true);
+    i2c_master_write_byte(i2c_cmd, register_addr, true);
+    i2c_master_write_byte(i2c_cmd, data, true);
+    i2c_master_stop(i2c_cmd);
+    esp_err_t ret = i2c_master_cmd_begin(I2C_NUM_0, i2c_cmd, 1000 / portTICK_RATE_MS);
+    i2c_cmd_link_delete(i2c_cmd);
+    return ret;
+}
+
+#if FT6X36_INT_MODE
+static void IRAM_ATTR ft6x36_int_handler(void *arg) {
+    int_pending = true;
+}
+#endif
+
+/**
+  * @brief  Read the FT6x36 gesture ID. Initialize first!
+  * @param  dev_addr: I2C FT6x36 Slave address.
+  * @retval The gesture ID or 0x00 in case of failure
+  */
+uint8_t ft6x36_get_gesture_id() {
+    if (!ft6x36_status.inited) {
+        ESP_LOGE(TAG, "Init first!");
+        return 0x00;
+    }
+    uint8_t data_buf;
+    esp_err_t ret;
+    if ((ret = ft6x06_i2c_read8(current_dev_addr, FT6X36_GEST_ID_REG, &data_buf) != ESP_OK))
+        ESP_LOGE(TAG, "Error reading from device: %s", esp_err_to_name(ret));
+    return data_buf;
+}
+
+#if FT6X36_GESTURES
+/**
+  * @brief  Get the gesture recognized by the last reads, once. Call it from
+  *         the task that calls ft6x36_read(), no I2C traffic.
+  * @retval The gesture ID or FT6X36_GEST_ID_NO_GESTURE
+  */
+uint8_t ft6x36_take_gesture(void) {
+    uint8_t gesture = new_gesture;
+    new_gesture = FT6X36_GEST_ID_NO_GESTURE;
+    return gesture;
+}
+#endif
+
+/**
+  * @brief  Check for an FT6x36 on the I2C bus. The I2C driver is removed
+  *         again, ft6x36_init() installs it for good.
+  * @param  dev_addr: I2C FT6x36 Slave address.
+  * @retval true if the panel ID register could be read
+  */
+bool ft6x36_probe(uint16_t dev_addr) {
+    if (ft6x36_status.inited) return true;
+    if (i2c_master_init() != ESP_OK) return false;
+
+    uint8_t panel_id;
+    esp_err_t ret = ft6x06_i2c_read8(dev_addr, FT6X36_PANEL_ID_REG, &panel_id);
+    i2c_driver_delete(I2C_NUM_0);
+
+    if (ret != ESP_OK) return false;
+    ESP_LOGI(TAG, "Probe: panel ID 0x%02x at 0x%02x", panel_id, dev_addr);
+    return true;
+}
+
+/**
+  * @brief  Initialize for FT6x36 communication via I2C
+  * @param  dev_addr: Device address on communication Bus (I2C slave address of FT6X36).
+  * @retval None
+  */
+void ft6x36_init(uint16_t dev_addr) {
+    if (!ft6x36_status.inited) {
+        esp_err_t code = i2c_master_init();
+        if (code != ESP_OK) {
+            ft6x36_status.inited = false;
+            ESP_LOGE(TAG, "Error during I2C init %s", esp_err_to_name(code));
+        } else {
+            ft6x36_status.inited = true;
+            current_dev_addr = dev_addr;
+            static const touch_filter_cfg_t filter_cfg = TOUCH_FILTER_CFG(FT6X36);
+            touch_filter_init(&filter, &filter_cfg);
+            uint8_t data_buf;
+            esp_err_t ret;
+            ESP_LOGI(TAG, "Found touch panel controller");
+            if ((ret = ft6x06_i2c_read8(dev_addr, FT6X36_PANEL_ID_REG, &data_buf) != ESP_OK))
+                ESP_LOGE(TAG, "Error reading from device: %s",
+                         esp_err_to_name(ret));    // Only show error the first time
+            ESP_LOGI(TAG, "\tDevice ID: 0x%02x", data_buf);
+
+            ft6x06_i2c_read8(dev_addr, FT6X36_CHIPSELECT_REG, &data_buf);
+            ESP_LOGI(TAG, "\tChip ID: 0x%02x", data_buf);
+
+            ft6x06_i2c_read8(dev_addr, FT6X36_DEV_MODE_REG, &data_buf);
+            ESP_LOGI(TAG, "\tDevice mode: 0x%02x", data_buf);
+
+            ft6x06_i2c_read8(dev_addr, FT6X36_FIRMWARE_ID_REG, &data_buf);
+            ESP_LOGI(TAG, "\tFirmware ID: 0x%02x", data_buf);
+
+            ft6x06_i2c_read8(dev_addr, FT6X36_RELEASECODE_REG, &data_buf);
+            ESP_LOGI(TAG, "\tRelease code: 0x%02x", data_buf);
+
+#if FT6X36_INT_MODE
+            // INT stays low while touched, so a falling edge starts each touch
+            ft6x36_i2c_write8(dev_addr, FT6X36_G_MODE_REG, FT6X36_G_MODE_POLLING);
+
+            gpio_config_t int_config = {
+                .pin_bit_mask = BIT64(FT6X36_INT),
+                .mode = GPIO_MODE_INPUT,
+                .pull_up_en = GPIO_PULLUP_ENABLE,
+                .pull_down_en = GPIO_PULLDOWN_DISABLE,
+                .intr_type = GPIO_INTR_NEGEDGE,
+            };
+            ret = gpio_config(&int_config);
+            assert(ret == ESP_OK);
+
+            // The service may already be installed by someone else
+            ret = gpio_install_isr_service(0);
+            assert(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE);
+            ret = gpio_isr_handler_add(FT6X36_INT, ft6x36_int_handler, NULL);
+            assert(ret == ESP_OK);
+            ESP_LOGI(TAG, "\tInterrupt on GPIO %d", FT6X36_INT);
+#endif
+        }
+    }
+}
+
+#if FT6X36_GESTURES
+/**
+  * @brief  Remember a newly recognized gesture for ft6x36_take_gesture()
+  */
+static void track_gesture(uint8_t gesture, uint8_t cnt) {
+    if (gesture != FT6X36_GEST_ID_NO_GESTURE && gesture != last_gesture) {
+        ESP_LOGD(TAG, "Gesture 0x%02x", gesture);
+        new_gesture = gesture;
+    }
+    // The ID stays set after the gesture, a new touch may repeat it
+    last_gesture = cnt == 0 ? FT6X36_GEST_ID_NO_GESTURE : gesture;
+}
+#endif
+
+/**
+  * @brief  Filter a point and hand it to LVGL
+  * @retval Always false
+  */
+static bool ft6x36_report(lv_indev_data_t *data, bool pressed, int16_t x, int16_t y) {
+    pressed = touch_filter_apply(&filter, pressed, &x, &y);
+    data->point.x = x;
+    data->point.y = y;
+    data->state = pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    return false;
+}
+
+/**
+  * @brief  Get the touch screen X and Y positions values. The first touch is
+  *         reported until it is lifted, the others are available through
+  *         ft6x36_get_touches().
+  * @param  drv:
+  * @param  data: Store data here
+  * @retval Always false
+  */
+bool ft6x36_read(lv_indev_drv_t *drv, lv_indev_data_t *data) {
+    uint8_t buf[FT6X36_TOUCH_DATA_LEN];     // GEST_ID, TD_STAT and both points
+    static int16_t last_x = 0;  // 12bit pixel value
+    static int16_t last_y = 0;  // 12bit pixel value
+
+#if FT6X36_INT_MODE
+    // No I2C traffic until the controller signals a touch
+    if (!int_pending && !touch_active) {
+        return ft6x36_report(data, false, last_x, last_y);
+    }
+    int_pending = false;
+#endif
+
+    esp_err_t ret = ft6x36_i2c_read(current_dev_addr, FT6X36_GEST_ID_REG, buf, sizeof(buf));
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Error getting touch data: %s", esp_err_to_name(ret));
+        touches.count = 0;
+        return ft6x36_report(data, false, last_x, last_y);
+    }
+
+    uint8_t cnt = buf[1] & FT6X36_TD_STAT_MASK;
+    if (cnt > FT6X36_MAX_TOUCH_PNTS) cnt = 0;  // 0x0F until the first touch after power up
+    touches.count = cnt;
+#if FT6X36_INT_MODE
+    // Keep reading until the release is seen
+    touch_active = cnt > 0;
+#endif
+#if FT6X36_GESTURES
+    track_gesture(buf[0], cnt);
+#endif
+
+    uint8_t primary = 0;
+    bool found = false;
+    for (uint8_t i = 0; i < cnt; i++) {
+        const uint8_t *p = &buf[2 + i * FT6X36_POINT_LEN];
+        ft6x36_touch_t *t = &touches.point[i];
+
+        t->event = (p[0] & FT6X36_TOUCH_EVT_FLAG_MASK) >> FT6X36_TOUCH_EVT_FLAG_SHIFT;
+        t->id = p[2] >> FT6X36_TOUCH_ID_SHIFT;
+        t->weight = p[4];
+        t->area = p[5] >> FT6X36_TOUCH_AREA_SHIFT;
+
+        int16_t x = ((p[0] & FT6X36_MSB_MASK) << 8) | (p[1] & FT6X36_LSB_MASK);
+        int16_t y = ((p[2] & FT6X36_MSB_MASK) << 8) | (p[3] & FT6X36_LSB_MASK);
+#if CONFIG_LVGL_FT6X36_SWAPXY
+        int16_t swap_buf = x;
+        x = y;
+        y = swap_buf;
+#endif
+#if CONFIG_LVGL_FT6X36_INVERT_X
+        x = LV_HOR_RES - x;
+#endif
+#if CONFIG_LVGL_FT6X36_INVERT_Y
+        y = LV_VER_RES - y;
+#endif
+        t->point.x = x;
+        t->point.y = y;
+
+        if (t->id == primary_id) {
+            primary = i;
+            found = true;
+        }
+    }
+
+    if (cnt == 0) {
+        primary_down = false;
+        return ft6x36_report(data, false, last_x, last_y);
+    }
+
+    // The followed finger lifted while another one stays down. Release it
+    // first, a jump to the other finger would look like a drag.
+    if (!found && primary_down) {
+        primary_id = touches.point[0].id;
+        primary_down = false;
+        touch_filter_reset(&filter);
+        return ft6x36_report(data, false, last_x, last_y);
+    }
+
+    // Keep following the same finger while a second one comes and goes
+    primary_id = touches.point[primary].id;
+    primary_down = true;
+    last_x = touches.point[primary].point.x;
+    last_y = touches.point[primary].point.y;
+
+    ESP_LOGV(TAG, "X=%u Y=%u (%u points)", last_x, last_y, cnt);
+    return ft6x36_report(data, true, last_x, last_y);
+}
+
+/**
+  * @brief  Get all touch points of the last ft6x36_read()
+  * @param  t: Store the points here, in screen coordinates without filtering
+  * @retval Number of points
+  */
+uint8_t ft6x36_get_touches(ft6x36_touches_t *t) {
+    *t = touches;
+    return touches.count;
+}
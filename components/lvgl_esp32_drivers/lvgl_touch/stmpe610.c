@@ -1,242 +1,339 @@
-/**
- * @file STMPE610.c
- */
-
-/*********************
- *      INCLUDES
- *********************/
-#include "stmpe610.h"
-#include "esp_system.h"
-#include "esp_log.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-#include "driver/gpio.h"
-#include "tp_spi.h"
-#include <stddef.h>
-
-/*********************
- *      DEFINES
- *********************/
-#define TAG        "STMPE610"
-
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-/**********************
- *  STATIC PROTOTYPES
- **********************/
-static void write_8bit_reg(uint8_t reg, uint8_t val);
-static uint16_t read_16bit_reg(uint8_t reg);
-static uint8_t read_8bit_reg(uint8_t reg);
-static void read_data(int16_t *x, int16_t *y, uint8_t *z);
-static bool buffer_empty();
-static void adjust_data(int16_t * x, int16_t * y);
-
-
-/**********************
- *  STATIC VARIABLES
- **********************/
-
-/**********************
- *      MACROS
- **********************/
-
-/**********************
- *   GLOBAL FUNCTIONS
- **********************/
-
-/**
- * Initialize the STMPE610
- */
-void stmpe610_init(void)
-{
-	uint8_t u8;
-	uint16_t u16;
-	
-	ESP_LOGI(TAG, "Initialization.");
-
-	// Get the initial SPI configuration
-	//u8 = read_8bit_reg(STMPE_SPI_CFG);
-	//ESP_LOGI(TAG, "SPI_CFG = 0x%x", u8);
-	
-    // Attempt a software reset
-	write_8bit_reg(STMPE_SYS_CTRL1, STMPE_SYS_CTRL1_RESET);
-	vTaskDelay(10 / portTICK_RATE_MS);
-	
-	// Reset the SPI configuration, making sure auto-increment is set
-	u8 = read_8bit_reg(STMPE_SPI_CFG);
-	write_8bit_reg(STMPE_SPI_CFG, u8 | STMPE_SPI_CFG_AA);
-	u8 = read_8bit_reg(STMPE_SPI_CFG);
-	ESP_LOGI(TAG, "SPI_CFG = 0x%x", u8);
-	
-	// Verify SPI communication
-	u16 = read_16bit_reg(STMPE_CHIP_ID);
-	if (u16 != 0x811) {
-		ESP_LOGE(TAG, "Incorrect version: 0x%x", u16);
-	}
-
-	write_8bit_reg(STMPE_SYS_CTRL2, 0x00); // Disable clocks
-	write_8bit_reg(STMPE_TSC_CTRL, 0);     // Disable to allow writing
-	
-	write_8bit_reg(STMPE_TSC_CTRL,
-				   STEMP_TSC_CTRL_TRACK_0 | 
-                   STMPE_TSC_CTRL_XYZ |
-                   STMPE_TSC_CTRL_EN);
-	
-	write_8bit_reg(STMPE_TSC_CFG, STMPE_TSC_CFG_4SAMPLE |
-				   STMPE_TSC_CFG_DELAY_1MS |
-                   STMPE_TSC_CFG_SETTLE_1MS);
-                   
-	write_8bit_reg(STMPE_TSC_FRACTION_Z, 0x7);
-	write_8bit_reg(STMPE_TSC_I_DRIVE, STMPE_TSC_I_DRIVE_50MA);
-	
-	write_8bit_reg(STMPE_SYS_CTRL2, 0x04); // GPIO clock off, TSC clock on, ADC clock on
-	
-	write_8bit_reg(STMPE_ADC_CTRL1, STMPE_ADC_CTRL1_12BIT | STMPE_ADC_CTRL1_80CLK);
-	write_8bit_reg(STMPE_ADC_CTRL2, STMPE_ADC_CTRL2_3_25MHZ);
-	
-	write_8bit_reg(STMPE_GPIO_ALT_FUNCT, 0x00);  // Disable GPIO
-
-	write_8bit_reg(STMPE_FIFO_TH, 1);                      // Set FIFO threshold
-	write_8bit_reg(STMPE_FIFO_STA, STMPE_FIFO_STA_RESET);  // Assert FIFO reset
-	write_8bit_reg(STMPE_FIFO_STA, 0);                     // Deassert FIFO reset
-	
-	write_8bit_reg(STMPE_INT_EN, 0x00);  // No interrupts
-	write_8bit_reg(STMPE_INT_STA, 0xFF); // reset all ints
-}
-
-/**
- * Get the current position and state of the touchpad
- * @param data store the read data here
- * @return false: because no more data to be read
- */
-bool stmpe610_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
-{
-    static int16_t last_x = 0;
-    static int16_t last_y = 0;
-    bool valid = true;
-	int c = 0;
-    int16_t x = 0;
-    int16_t y = 0;
-    uint8_t z;
-
-    if ((read_8bit_reg(STMPE_TSC_CTRL) & STMPE_TSC_TOUCHED) == STMPE_TSC_TOUCHED) {
-		// Making sure that we read all data and return the latest point
-		while (!buffer_empty()) {
-			read_data(&x, &y, &z);
-			c++;
-		}
-		
-		if (c > 0) {
-			//ESP_LOGI(TAG, "%d: %d %d %d", c, x, y, z);
-		
-			adjust_data(&x, &y);
-    		last_x = x;
-    		last_y = y;
-    		//ESP_LOGI(TAG, "  ==> %d %d", x, y);
-    	}
-    	
-    	z = read_8bit_reg(STMPE_INT_STA);  // Clear interrupts
-    	z = read_8bit_reg(STMPE_FIFO_STA);
-    	if ((z & STMPE_FIFO_STA_OFLOW) == STMPE_FIFO_STA_OFLOW) {
-    		// Clear the FIFO if we discover an overflow
-    		write_8bit_reg(STMPE_FIFO_STA, STMPE_FIFO_STA_RESET);
-			write_8bit_reg(STMPE_FIFO_STA, 0); // unreset
-			ESP_LOGE(TAG, "Fifo overflow");
-		}
-    }
-    
-    if (c == 0) {
-        x = last_x;
-        y = last_y;
-        valid = false;
-    }
-
-    data->point.x = (int16_t) x;
-    data->point.y = (int16_t) y;
-    data->state = valid == false ? LV_INDEV_STATE_REL : LV_INDEV_STATE_PR;
-
-    return false;
-}
-
-
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-static void write_8bit_reg(uint8_t reg, uint8_t val)
-{
-	uint8_t data_send[2];
-	
-	data_send[0] = reg;
-	data_send[1] = val;
-	tp_spi_write_reg(data_send, 2);
-}
-
-
-static uint16_t read_16bit_reg(uint8_t reg)
-{
-	uint8_t data_recv[2];
-	
-	tp_spi_read_reg(0x80 | reg, data_recv, 2);
-	
-	return data_recv[0] << 8 | data_recv[1];
-}
-
-
-static uint8_t read_8bit_reg(uint8_t reg)
-{	
-	uint8_t data_recv;
-	
-	tp_spi_read_reg(0x80 | reg, &data_recv, 1);
-	
-	return data_recv;
-}
-
-
-static void read_data(int16_t *x, int16_t *y, uint8_t *z)
-{
-	*x = read_16bit_reg(STMPE_TSC_DATA_X);
-	*y = read_16bit_reg(STMPE_TSC_DATA_Y);
-	*z = read_8bit_reg(STMPE_TSC_DATA_Z);
-}
-
-
-static bool buffer_empty()
-{
-	return ((read_8bit_reg(STMPE_FIFO_STA) & STMPE_FIFO_STA_EMPTY) == STMPE_FIFO_STA_EMPTY);
-}
-
-
-static void adjust_data(int16_t * x, int16_t * y)
-{
-#if STMPE610_XY_SWAP != 0
-    int16_t swap_tmp;
-    swap_tmp = *x;
-    *x = *y;
-    *y = swap_tmp;
-#endif
-
-    if((*x) > STMPE610_X_MIN)(*x) -= STMPE610_X_MIN;
-    else(*x) = 0;
-
-    if((*y) > STMPE610_Y_MIN)(*y) -= STMPE610_Y_MIN;
-    else(*y) = 0;
-
-    (*x) = (uint32_t)((uint32_t)(*x) * LV_HOR_RES) /
-           (STMPE610_X_MAX - STMPE610_X_MIN);
-
-    (*y) = (uint32_t)((uint32_t)(*y) * LV_VER_RES) /
-           (STMPE610_Y_MAX - STMPE610_Y_MIN);
-
-#if STMPE610_X_INV != 0
-    (*x) =  LV_HOR_RES - (*x);
-#endif
-
-#if STMPE610_Y_INV != 0
-    (*y) =  LV_VER_RES - (*y);
-#endif
-
-}
-
+/**
+ * @file STMPE610.c
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "stmpe610.h"
+#include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "tp_spi.h"
+#include "touch_filter.h"
+#include "touch_calib.h"
+#include <stddef.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG        "STMPE610"
+
+/* TSC_DATA: FIFO read port that keeps its address in auto-increment mode,
+ * so a burst returns consecutive samples of 4 bytes packed X, Y and Z */
+#define STMPE_TSC_DATA  0x57
+#define SAMPLE_BYTES    4
+#define BURST_SAMPLES   32
+
+/* TSC_CTRL up to FIFO_SIZE in one auto-increment burst */
+#define STATUS_LEN      (STMPE_FIFO_SIZE - STMPE_TSC_CTRL + 1)
+
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void write_8bit_reg(uint8_t reg, uint8_t val);
+static uint16_t read_16bit_reg(uint8_t reg);
+static uint8_t read_8bit_reg(uint8_t reg);
+static void read_burst(uint8_t reg, uint8_t *data, uint8_t byte_count);
+static bool read_fifo(int16_t *x, int16_t *y);
+static void adjust_data(int16_t * x, int16_t * y);
+#if STMPE610_INT_MODE
+static void IRAM_ATTR stmpe610_int_handler(void * arg);
+#endif
+
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static touch_filter_t filter;
+static WORD_ALIGNED_ATTR uint8_t fifo_buf[BURST_SAMPLES * SAMPLE_BYTES];
+
+#if STMPE610_INT_MODE
+static volatile bool int_pending = true;   /*Read once at start in case the panel is touched*/
+static bool touch_active;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Check for an STMPE610 on the touch SPI device
+ * @return true if the chip ID register reads STMPE_ID
+ */
+bool stmpe610_probe(void)
+{
+	uint16_t u16 = read_16bit_reg(STMPE_CHIP_ID);
+
+	ESP_LOGI(TAG, "Probe: chip ID 0x%x", u16);
+	return u16 == STMPE_ID;
+}
+
+/**
+ * Initialize the STMPE610
+ */
+void stmpe610_init(void)
+{
+	uint8_t u8;
+	uint16_t u16;
+	
+	ESP_LOGI(TAG, "Initialization.");
+
+	// Get the initial SPI configuration
+	//u8 = read_8bit_reg(STMPE_SPI_CFG);
+	//ESP_LOGI(TAG, "SPI_CFG = 0x%x", u8);
+	
+    // Attempt a software reset
+	write_8bit_reg(STMPE_SYS_CTRL1, STMPE_SYS_CTRL1_RESET);
+	vTaskDelay(10 / portTICK_RATE_MS);
+	
+	// Reset the SPI configuration, making sure auto-increment is set
+	u8 = read_8bit_reg(STMPE_SPI_CFG);
+	write_8bit_reg(STMPE_SPI_CFG, u8 | STMPE_SPI_CFG_AA);
+
+	// Verify SPI communication
+	tp_spi_reg_t id[] = {
+		{0x80 | STMPE_SPI_CFG},
+		{0x80 | STMPE_CHIP_ID},
+		{0x80 | (STMPE_CHIP_ID + 1)},
+	};
+	tp_spi_read_regs(id, sizeof(id) / sizeof(id[0]));
+	ESP_LOGI(TAG, "SPI_CFG = 0x%x", id[0].val);
+
+	u16 = id[1].val << 8 | id[2].val;
+	if (u16 != STMPE_ID) {
+		ESP_LOGE(TAG, "Incorrect version: 0x%x", u16);
+	}
+
+	static const tp_spi_reg_t config[] = {
+		{STMPE_SYS_CTRL2, 0x00},               // Disable clocks
+		{STMPE_TSC_CTRL, 0},                   // Disable to allow writing
+		{STMPE_TSC_CTRL, STEMP_TSC_CTRL_TRACK_0 | STMPE_TSC_CTRL_XYZ | STMPE_TSC_CTRL_EN},
+		{STMPE_TSC_CFG, STMPE_TSC_CFG_4SAMPLE | STMPE_TSC_CFG_DELAY_1MS | STMPE_TSC_CFG_SETTLE_1MS},
+		{STMPE_TSC_FRACTION_Z, 0x7},
+		{STMPE_TSC_I_DRIVE, STMPE_TSC_I_DRIVE_50MA},
+		{STMPE_SYS_CTRL2, 0x04},               // GPIO clock off, TSC clock on, ADC clock on
+		{STMPE_ADC_CTRL1, STMPE_ADC_CTRL1_12BIT | STMPE_ADC_CTRL1_80CLK},
+		{STMPE_ADC_CTRL2, STMPE_ADC_CTRL2_3_25MHZ},
+		{STMPE_GPIO_ALT_FUNCT, 0x00},          // Disable GPIO
+		{STMPE_FIFO_TH, 1},                    // Set FIFO threshold
+		{STMPE_FIFO_STA, STMPE_FIFO_STA_RESET},// Assert FIFO reset
+		{STMPE_FIFO_STA, 0},                   // Deassert FIFO reset
+	};
+	tp_spi_write_regs(config, sizeof(config) / sizeof(config[0]));
+	
+#if STMPE610_INT_MODE
+	gpio_config_t int_config = {
+		.pin_bit_mask = BIT64(STMPE610_INT),
+		.mode = GPIO_MODE_INPUT,
+		.pull_up_en = GPIO_PULLUP_ENABLE,
+		.pull_down_en = GPIO_PULLDOWN_DISABLE,
+		.intr_type = GPIO_INTR_NEGEDGE,
+	};
+	esp_err_t ret = gpio_config(&int_config);
+	assert(ret == ESP_OK);
+
+	// The service may already be installed by someone else
+	ret = gpio_install_isr_service(0);
+	assert(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE);
+	ret = gpio_isr_handler_add(STMPE610_INT, stmpe610_int_handler, NULL);
+	assert(ret == ESP_OK);
+
+	static const tp_spi_reg_t int_regs[] = {
+		{STMPE_INT_STA, 0xFF},                 // reset all ints
+		{STMPE_INT_EN, STMPE_INT_EN_TOUCHDET | STMPE_INT_EN_FIFOTH},
+		{STMPE_INT_CTRL, STMPE_INT_CTRL_POL_LOW | STMPE_INT_CTRL_LEVEL | STMPE_INT_CTRL_ENABLE},
+	};
+	tp_spi_write_regs(int_regs, sizeof(int_regs) / sizeof(int_regs[0]));
+	ESP_LOGI(TAG, "Interrupt on GPIO %d", STMPE610_INT);
+#else
+	write_8bit_reg(STMPE_INT_EN, 0x00);  // No interrupts
+	write_8bit_reg(STMPE_INT_STA, 0xFF); // reset all ints
+#endif
+
+	static const touch_filter_cfg_t filter_cfg = TOUCH_FILTER_CFG(STMPE610);
+	touch_filter_init(&filter, &filter_cfg);
+}
+
+/**
+ * Get the current position and state of the touchpad
+ * @param data store the read data here
+ * @return false: because no more data to be read
+ */
+bool stmpe610_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
+{
+    bool valid = false;
+    int16_t x = 0;
+    int16_t y = 0;
+
+#if STMPE610_INT_MODE
+    // Nothing to read until the controller signals a touch
+    if (int_pending || touch_active) {
+        int_pending = false;
+        valid = read_fifo(&x, &y);
+    }
+#else
+    valid = read_fifo(&x, &y);
+#endif
+
+    if (!valid) {
+        valid = touch_filter_apply(&filter, false, &x, &y);
+    }
+
+    data->point.x = (int16_t) x;
+    data->point.y = (int16_t) y;
+    data->state = valid == false ? LV_INDEV_STATE_REL : LV_INDEV_STATE_PR;
+
+    return false;
+}
+
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static void write_8bit_reg(uint8_t reg, uint8_t val)
+{
+	uint8_t data_send[2];
+	
+	data_send[0] = reg;
+	data_send[1] = val;
+	tp_spi_write_reg(data_send, 2);
+}
+
+
+static uint16_t read_16bit_reg(uint8_t reg)
+{
+	uint8_t data_recv[2];
+	
+	tp_spi_read_reg(0x80 | reg, data_recv, 2);
+	
+	return data_recv[0] << 8 | data_recv[1];
+}
+
+
+static uint8_t read_8bit_reg(uint8_t reg)
+{	
+	uint8_t data_recv;
+	
+	tp_spi_read_reg(0x80 | reg, &data_recv, 1);
+	
+	return data_recv;
+}
+
+
+/* Drain the FIFO through the filter in two transactions plus one per
+ * BURST_SAMPLES samples. Returns false if no touched sample was read. */
+static bool read_fifo(int16_t *x, int16_t *y)
+{
+	bool valid = false;
+	uint8_t status[STATUS_LEN];
+
+	// One sample as a whole, on a shared bus the display waits in between
+	tp_spi_acquire_bus();
+	read_burst(STMPE_TSC_CTRL, status, STATUS_LEN);
+
+	bool touched = (status[0] & STMPE_TSC_TOUCHED) == STMPE_TSC_TOUCHED;
+	uint8_t fifo_sta = status[STMPE_FIFO_STA - STMPE_TSC_CTRL];
+	uint8_t fifo_size = status[STMPE_FIFO_SIZE - STMPE_TSC_CTRL];
+
+	// Samples left after a release are dropped
+	while (fifo_size > 0) {
+		uint8_t n = fifo_size < BURST_SAMPLES ? fifo_size : BURST_SAMPLES;
+		read_burst(STMPE_TSC_DATA, fifo_buf, n * SAMPLE_BYTES);
+		fifo_size -= n;
+
+		for (uint8_t i = 0; touched && i < n; i++) {
+			const uint8_t *d = &fifo_buf[i * SAMPLE_BYTES];
+			*x = (d[0] << 4) | (d[1] >> 4);
+			*y = ((d[1] & 0x0F) << 8) | d[2];
+			adjust_data(x, y);
+			// Every point goes through the filter, the latest one is reported
+			touch_filter_apply(&filter, true, x, y);
+			valid = true;
+		}
+	}
+
+	if ((fifo_sta & STMPE_FIFO_STA_OFLOW) == STMPE_FIFO_STA_OFLOW) {
+		// Clear the FIFO if we discover an overflow
+		static const tp_spi_reg_t fifo_reset[] = {
+			{STMPE_FIFO_STA, STMPE_FIFO_STA_RESET},
+			{STMPE_FIFO_STA, 0},           // unreset
+		};
+		tp_spi_write_regs(fifo_reset, 2);
+		ESP_LOGE(TAG, "Fifo overflow");
+	}
+
+#if STMPE610_INT_MODE
+	// Keep reading until the release is seen, then wait for the next interrupt
+	write_8bit_reg(STMPE_INT_STA, 0xFF);
+	touch_active = touched;
+#endif
+	tp_spi_release_bus();
+
+	return valid;
+}
+
+
+/* Auto-increment read of consecutive registers, or of the FIFO at STMPE_TSC_DATA */
+static void read_burst(uint8_t reg, uint8_t *data, uint8_t byte_count)
+{
+	tp_spi_read_reg(0x80 | reg, data, byte_count);
+}
+
+
+#if STMPE610_INT_MODE
+static void IRAM_ATTR stmpe610_int_handler(void * arg)
+{
+	int_pending = true;
+}
+#endif
+
+
+static void adjust_data(int16_t * x, int16_t * y)
+{
+#if TOUCH_CALIB_ENABLED
+    /*The stored matrix covers swap, inversion and scaling*/
+    if(touch_calib_map(x, y)) return;
+#endif
+
+#if STMPE610_XY_SWAP != 0
+    int16_t swap_tmp;
+    swap_tmp = *x;
+    *x = *y;
+    *y = swap_tmp;
+#endif
+
+    if((*x) > STMPE610_X_MIN)(*x) -= STMPE610_X_MIN;
+    else(*x) = 0;
+
+    if((*y) > STMPE610_Y_MIN)(*y) -= STMPE610_Y_MIN;
+    else(*y) = 0;
+
+    (*x) = (uint32_t)((uint32_t)(*x) * LV_HOR_RES) /
+           (STMPE610_X_MAX - STMPE610_X_MIN);
+
+    (*y) = (uint32_t)((uint32_t)(*y) * LV_VER_RES) /
+           (STMPE610_Y_MAX - STMPE610_Y_MIN);
+
+#if STMPE610_X_INV != 0
+    (*x) =  LV_HOR_RES - (*x);
+#endif
+
+#if STMPE610_Y_INV != 0
+    (*y) =  LV_VER_RES - (*y);
+#endif
+
+}
+
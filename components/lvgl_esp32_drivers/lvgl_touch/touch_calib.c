@@ -0,0 +1,448 @@
+/**
+ * @file touch_calib.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_calib.h"
+
+#if TOUCH_CALIB_ENABLED
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "touch_calib"
+
+#define NVS_NAMESPACE   "touch_calib"
+#define NVS_KEY         "matrix"
+#define BLOB_MAGIC      0x54434101      /*"TCA", version 1*/
+
+#define POLL_PERIOD     50      /*Calibration screen poll period [ms]*/
+#define RELEASE_POLLS   3       /*Polls without new samples that end a press*/
+#define MIN_SAMPLES     4       /*Shorter presses are ignored*/
+#define MAX_ERROR       8       /*Largest accepted residual with 4+ points [px]*/
+#define TARGET_SIZE     20
+#define TARGET_MARGIN   10      /*Distance of the outer targets from the edges [%]*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t magic;
+    lv_coord_t hor_res;         /*A different resolution or rotation invalidates the matrix*/
+    lv_coord_t ver_res;
+    touch_calib_t m;
+} calib_blob_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool solve3(const double a[3][3], const double r[3], double out[3]);
+static void screen_task(lv_task_t * task);
+static void show_target(void);
+static void finish(bool ok);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/*The drivers may map from their own task: a new matrix is written to the
+ *unused slot and then published by switching the pointer*/
+static touch_calib_t slots[2];
+static const touch_calib_t * volatile active;
+
+/*Raw samples of the current press, summed by touch_calib_map()*/
+static volatile bool collecting;
+static int32_t sum_x;
+static int32_t sum_y;
+static uint32_t sum_cnt;
+static portMUX_TYPE sum_mux = portMUX_INITIALIZER_UNLOCKED;
+
+/*Calibration screen*/
+static lv_obj_t * prev_scr;
+static lv_obj_t * scr;
+static lv_obj_t * label;
+static lv_obj_t * target;
+static lv_task_t * poll_task;
+static lv_style_t target_style;
+static touch_calib_done_cb_t done;
+static uint8_t point_cnt;
+static uint8_t step;
+static uint32_t last_cnt;
+static uint8_t idle_polls;
+static lv_point_t scr_pts[TOUCH_CALIB_MAX_POINTS];
+static lv_point_t raw_pts[TOUCH_CALIB_MAX_POINTS];
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Load the calibration stored in NVS. nvs_flash_init() must have been called.
+ * @return true if a valid calibration was loaded
+ */
+bool touch_calib_init(void)
+{
+    nvs_handle_t nvs;
+    calib_blob_t blob;
+    size_t len = sizeof(blob);
+
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if(ret != ESP_OK) {
+        ESP_LOGI(TAG, "Not calibrated");
+        return false;
+    }
+    ret = nvs_get_blob(nvs, NVS_KEY, &blob, &len);
+    nvs_close(nvs);
+
+    if(ret != ESP_OK || len != sizeof(blob) || blob.magic != BLOB_MAGIC ||
+       blob.hor_res != LV_HOR_RES || blob.ver_res != LV_VER_RES) {
+        ESP_LOGI(TAG, "Not calibrated for this display");
+        return false;
+    }
+
+    touch_calib_set(&blob.m);
+    ESP_LOGI(TAG, "Loaded calibration");
+    return true;
+}
+
+/**
+ * Map a raw point to screen coordinates, called from the drivers' read path.
+ * @param x raw x value, replaced by the screen x coordinate
+ * @param y raw y value, replaced by the screen y coordinate
+ * @return false if not calibrated, the point is left untouched then
+ */
+bool touch_calib_map(int16_t * x, int16_t * y)
+{
+    if(collecting) {
+        portENTER_CRITICAL(&sum_mux);
+        sum_x += *x;
+        sum_y += *y;
+        sum_cnt++;
+        portEXIT_CRITICAL(&sum_mux);
+    }
+
+    const touch_calib_t * m = active;
+    if(m == NULL) return false;
+
+    int32_t rx = *x;
+    int32_t ry = *y;
+    *x = (int16_t)(((int64_t)m->a * rx + (int64_t)m->b * ry + m->c + 0x8000) >> 16);
+    *y = (int16_t)(((int64_t)m->d * rx + (int64_t)m->e * ry + m->f + 0x8000) >> 16);
+
+    return true;
+}
+
+/**
+ * Least squares fit of the affine matrix to point pairs.
+ * @param scr the target positions on the screen
+ * @param raw the raw values measured at the targets
+ * @param n number of pairs, at least 3 not on one line
+ * @param m store the matrix here
+ * @return false if the points do not determine a matrix
+ */
+bool touch_calib_compute(const lv_point_t * scr, const lv_point_t * raw, uint8_t n, touch_calib_t * m)
+{
+    if(n < 3) return false;
+
+    /*Normal equations: sum of [rx ry 1]^T [rx ry 1] times the coefficients
+     *equals sum of [rx ry 1]^T times the screen coordinate*/
+    double ata[3][3] = {{0}};
+    double atx[3] = {0};
+    double aty[3] = {0};
+
+    for(uint8_t i = 0; i < n; i++) {
+        double v[3] = {raw[i].x, raw[i].y, 1.0};
+        for(uint8_t r = 0; r < 3; r++) {
+            for(uint8_t c = 0; c < 3; c++) ata[r][c] += v[r] * v[c];
+            atx[r] += v[r] * scr[i].x;
+            aty[r] += v[r] * scr[i].y;
+        }
+    }
+
+    double cx[3];
+    double cy[3];
+    if(!solve3(ata, atx, cx) || !solve3(ata, aty, cy)) return false;
+
+    m->a = lround(cx[0] * 65536.0);
+    m->b = lround(cx[1] * 65536.0);
+    m->c = lround(cx[2] * 65536.0);
+    m->d = lround(cy[0] * 65536.0);
+    m->e = lround(cy[1] * 65536.0);
+    m->f = lround(cy[2] * 65536.0);
+
+    return true;
+}
+
+/**
+ * Use a matrix in the read path.
+ * @param m the matrix, NULL to go back to the Kconfig scaling
+ */
+void touch_calib_set(const touch_calib_t * m)
+{
+    if(m == NULL) {
+        active = NULL;
+        return;
+    }
+
+    touch_calib_t * next = (active == &slots[0]) ? &slots[1] : &slots[0];
+    *next = *m;
+    active = next;
+}
+
+/**
+ * @param m store the matrix in use here
+ * @return false if not calibrated
+ */
+bool touch_calib_get(touch_calib_t * m)
+{
+    const touch_calib_t * cur = active;
+    if(cur == NULL) return false;
+
+    *m = *cur;
+    return true;
+}
+
+/**
+ * Store the matrix in use in NVS.
+ * @return ESP_ERR_INVALID_STATE if not calibrated, otherwise the NVS result
+ */
+esp_err_t touch_calib_save(void)
+{
+    calib_blob_t blob = {
+        .magic = BLOB_MAGIC,
+        .hor_res = LV_HOR_RES,
+        .ver_res = LV_VER_RES,
+    };
+    if(!touch_calib_get(&blob.m)) return ESP_ERR_INVALID_STATE;
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if(ret != ESP_OK) return ret;
+
+    ret = nvs_set_blob(nvs, NVS_KEY, &blob, sizeof(blob));
+    if(ret == ESP_OK) ret = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    if(ret != ESP_OK) ESP_LOGE(TAG, "Saving failed: %s", esp_err_to_name(ret));
+    return ret;
+}
+
+/**
+ * Remove the stored calibration. The matrix in use is kept until restart.
+ * @return the NVS result, ESP_OK if nothing was stored
+ */
+esp_err_t touch_calib_erase(void)
+{
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if(ret != ESP_OK) return ret;
+
+    ret = nvs_erase_key(nvs, NVS_KEY);
+    if(ret == ESP_ERR_NVS_NOT_FOUND) ret = ESP_OK;
+    if(ret == ESP_OK) ret = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    return ret;
+}
+
+/**
+ * Show the calibration screen. The user touches `points` targets one after
+ * the other, the result is applied and saved, then the previous screen is
+ * loaded again. Call from the GUI task after the input device is registered.
+ * @param points 3 (corners), 4 (corners) or 5 (corners and center)
+ * @param done_cb called when finished, may be NULL
+ */
+void touch_calib_start(uint8_t points, touch_calib_done_cb_t done_cb)
+{
+    if(points < 3) points = 3;
+    if(points > TOUCH_CALIB_MAX_POINTS) points = TOUCH_CALIB_MAX_POINTS;
+
+    lv_coord_t x0 = LV_HOR_RES * TARGET_MARGIN / 100;
+    lv_coord_t x1 = LV_HOR_RES - 1 - x0;
+    lv_coord_t y0 = LV_VER_RES * TARGET_MARGIN / 100;
+    lv_coord_t y1 = LV_VER_RES - 1 - y0;
+    const lv_point_t pts[TOUCH_CALIB_MAX_POINTS] = {
+        {x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}, {LV_HOR_RES / 2, LV_VER_RES / 2}
+    };
+    memcpy(scr_pts, pts, sizeof(pts));
+
+    point_cnt = points;
+    done = done_cb;
+    step = 0;
+
+    prev_scr = lv_scr_act();
+    scr = lv_obj_create(NULL, NULL);
+
+    label = lv_label_create(scr, NULL);
+    lv_label_set_align(label, LV_LABEL_ALIGN_CENTER);
+
+    lv_style_copy(&target_style, &lv_style_plain_color);
+    target_style.body.main_color = LV_COLOR_RED;
+    target_style.body.grad_color = LV_COLOR_RED;
+    target_style.body.radius = LV_RADIUS_CIRCLE;
+    target = lv_obj_create(scr, NULL);
+    lv_obj_set_size(target, TARGET_SIZE, TARGET_SIZE);
+    lv_obj_set_style(target, &target_style);
+    lv_obj_set_click(target, false);
+
+    lv_disp_load_scr(scr);
+    show_target();
+
+    portENTER_CRITICAL(&sum_mux);
+    sum_x = 0;
+    sum_y = 0;
+    sum_cnt = 0;
+    portEXIT_CRITICAL(&sum_mux);
+    last_cnt = 0;
+    idle_polls = 0;
+    collecting = true;
+
+    poll_task = lv_task_create(screen_task, POLL_PERIOD, LV_TASK_PRIO_MID, NULL);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Gaussian elimination with partial pivoting */
+static bool solve3(const double a[3][3], const double r[3], double out[3])
+{
+    double m[3][3];
+    double b[3] = {r[0], r[1], r[2]};
+    memcpy(m, a, sizeof(m));
+
+    for(uint8_t c = 0; c < 3; c++) {
+        uint8_t p = c;
+        for(uint8_t i = c + 1; i < 3; i++) {
+            if(fabs(m[i][c]) > fabs(m[p][c])) p = i;
+        }
+        if(fabs(m[p][c]) < 1e-9) return false;
+
+        if(p != c) {
+            for(uint8_t k = 0; k < 3; k++) {
+                double t = m[c][k];
+                m[c][k] = m[p][k];
+                m[p][k] = t;
+            }
+            double t = b[c];
+            b[c] = b[p];
+            b[p] = t;
+        }
+
+        for(uint8_t i = c + 1; i < 3; i++) {
+            double f = m[i][c] / m[c][c];
+            for(uint8_t k = c; k < 3; k++) m[i][k] -= f * m[c][k];
+            b[i] -= f * b[c];
+        }
+    }
+
+    for(int8_t i = 2; i >= 0; i--) {
+        double s = b[i];
+        for(uint8_t k = i + 1; k < 3; k++) s -= m[i][k] * out[k];
+        out[i] = s / m[i][i];
+    }
+
+    return true;
+}
+
+/* A press ends when no new raw samples arrived for RELEASE_POLLS polls */
+static void screen_task(lv_task_t * task)
+{
+    (void)task;
+
+    portENTER_CRITICAL(&sum_mux);
+    int32_t sx = sum_x;
+    int32_t sy = sum_y;
+    uint32_t cnt = sum_cnt;
+    portEXIT_CRITICAL(&sum_mux);
+
+    if(cnt == 0) return;
+    if(cnt != last_cnt) {
+        last_cnt = cnt;
+        idle_polls = 0;
+        return;
+    }
+    if(++idle_polls < RELEASE_POLLS) return;
+
+    portENTER_CRITICAL(&sum_mux);
+    sum_x = 0;
+    sum_y = 0;
+    sum_cnt = 0;
+    portEXIT_CRITICAL(&sum_mux);
+    last_cnt = 0;
+    idle_polls = 0;
+
+    if(cnt < MIN_SAMPLES) return;
+
+    raw_pts[step].x = sx / (int32_t)cnt;
+    raw_pts[step].y = sy / (int32_t)cnt;
+    ESP_LOGI(TAG, "Point %d: screen %d,%d raw %d,%d", step + 1,
+             scr_pts[step].x, scr_pts[step].y, raw_pts[step].x, raw_pts[step].y);
+
+    if(++step < point_cnt) {
+        show_target();
+        return;
+    }
+
+    touch_calib_t m;
+    bool ok = touch_calib_compute(scr_pts, raw_pts, point_cnt, &m);
+
+    /*With more points than unknowns the fit can be checked*/
+    if(ok && point_cnt > 3) {
+        for(uint8_t i = 0; i < point_cnt; i++) {
+            int32_t ex = (((int64_t)m.a * raw_pts[i].x + (int64_t)m.b * raw_pts[i].y + m.c) >> 16) - scr_pts[i].x;
+            int32_t ey = (((int64_t)m.d * raw_pts[i].x + (int64_t)m.e * raw_pts[i].y + m.f) >> 16) - scr_pts[i].y;
+            if(abs(ex) > MAX_ERROR || abs(ey) > MAX_ERROR) {
+                ESP_LOGW(TAG, "Point %d off by %d,%d px", i + 1, ex, ey);
+                ok = false;
+            }
+        }
+    }
+
+    if(!ok) {
+        /*Start over*/
+        step = 0;
+        show_target();
+        lv_label_set_text(label, "Inaccurate, please try again.\nTouch the target.");
+        return;
+    }
+
+    touch_calib_set(&m);
+    finish(touch_calib_save() == ESP_OK);
+}
+
+static void show_target(void)
+{
+    static char buf[40];
+
+    lv_obj_set_pos(target, scr_pts[step].x - TARGET_SIZE / 2, scr_pts[step].y - TARGET_SIZE / 2);
+    snprintf(buf, sizeof(buf), "Touch the target.\n%d / %d", step + 1, point_cnt);
+    lv_label_set_text(label, buf);
+    lv_obj_align(label, NULL, LV_ALIGN_CENTER, 0, step == 4 ? -2 * TARGET_SIZE : 0);
+}
+
+static void finish(bool ok)
+{
+    collecting = false;
+    lv_task_del(poll_task);
+    poll_task = NULL;
+
+    lv_disp_load_scr(prev_scr);
+    lv_obj_del(scr);
+    scr = NULL;
+
+    ESP_LOGI(TAG, "Calibration %s", ok ? "saved" : "in use but not saved");
+    if(done) done(ok);
+}
+
+#endif /*TOUCH_CALIB_ENABLED*/
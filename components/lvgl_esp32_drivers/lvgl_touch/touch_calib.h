@@ -0,0 +1,70 @@
+/**
+ * @file touch_calib.h
+ *
+ * Affine calibration of resistive touch panels.
+ *
+ * The mapping from raw controller values to screen coordinates is
+ *     x = (a * raw_x + b * raw_y + c) >> 16
+ *     y = (d * raw_x + e * raw_y + f) >> 16
+ * which also covers swapped, mirrored, rotated and skewed panels. It is
+ * fitted to 3..5 touched targets, stored in NVS and replaces the
+ * per-driver X_MIN/MAX based scaling once present.
+ */
+
+#ifndef TOUCH_CALIB_H
+#define TOUCH_CALIB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_CALIB_ENABLED CONFIG_LVGL_TOUCH_CALIBRATION
+#if TOUCH_CALIB_ENABLED
+#define TOUCH_CALIB_POINTS  CONFIG_LVGL_TOUCH_CALIBRATION_POINTS
+#endif
+
+#define TOUCH_CALIB_MAX_POINTS 5
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int32_t a, b, c;    /*Screen x from raw x, raw y, 1 [Q16]*/
+    int32_t d, e, f;    /*Screen y from raw x, raw y, 1 [Q16]*/
+} touch_calib_t;
+
+typedef void (*touch_calib_done_cb_t)(bool ok);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool touch_calib_init(void);
+bool touch_calib_map(int16_t * x, int16_t * y);
+bool touch_calib_compute(const lv_point_t * scr, const lv_point_t * raw, uint8_t n, touch_calib_t * m);
+void touch_calib_set(const touch_calib_t * m);
+bool touch_calib_get(touch_calib_t * m);
+esp_err_t touch_calib_save(void);
+esp_err_t touch_calib_erase(void);
+void touch_calib_start(uint8_t points, touch_calib_done_cb_t done_cb);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TOUCH_CALIB_H*/
@@ -1,40 +1,348 @@
-/**
- * @file touch_driver.c
- */
-#include "touch_driver.h"
-#include "tp_spi.h"
-#include "tp_i2c.h"
-
-
-void touch_driver_init(bool init_spi)
-{
-#if CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_XPT2046
-	if (init_spi) {
-    	tp_spi_init();
-    }
-    xpt2046_init();
-#elif CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_FT6X06
-    ft6x36_init(FT6236_I2C_SLAVE_ADDR);
-#elif CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_STMPE610
-	if (init_spi) {
-    	tp_spi_init();
-    }
-	stmpe610_init();
-#endif
-}
-
-bool touch_driver_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
-{
-    bool res = false;
-
-#if CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_XPT2046
-    res = xpt2046_read(drv, data);
-#elif CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_FT6X06
-    res = ft6x36_read(drv, data);
-#elif CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_STMPE610
-	res = stmpe610_read(drv, data);
-#endif
-
-    return res;
-}
-
+/**
+ * @file touch_driver.c
+ */
+#include "touch_driver.h"
+#include "tp_spi.h"
+#include "tp_i2c.h"
+#include "touch_predict.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+#define TAG "touch_driver"
+
+/* One entry per driver built into the image */
+typedef struct {
+    const char *name;
+    uint8_t controller;
+    bool spi;                   /* on the touch SPI device */
+    bool (*probe)(void);
+    void (*init)(void);
+    bool (*read)(lv_indev_drv_t *drv, lv_indev_data_t *data);
+    TaskHandle_t (*get_task)(void);     /* NULL: no driver owned task */
+    int64_t (*get_time)(void);          /* acquisition of the last read point, NULL: at the read */
+} touch_driver_entry_t;
+
+#if TOUCH_DRIVER_FT6X06
+static bool ft6x36_probe_default(void);
+static void ft6x36_init_default(void);
+#endif
+#if TOUCH_DRIVER_FT6X06 && CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_AUTO
+static bool i2c_pins_free(void);
+#endif
+
+/* Probe order: ID registers first, the XPT2046 plausibility read last */
+static const touch_driver_entry_t drivers[] = {
+#if TOUCH_DRIVER_FT6X06
+    { "FT6X36", TOUCH_CONTROLLER_FT6X06, false, ft6x36_probe_default, ft6x36_init_default, ft6x36_read, NULL, NULL },
+#endif
+#if TOUCH_DRIVER_STMPE610
+    { "STMPE610", TOUCH_CONTROLLER_STMPE610, true, stmpe610_probe, stmpe610_init, stmpe610_read, NULL, NULL },
+#endif
+#if TOUCH_DRIVER_XPT2046
+    { "XPT2046", TOUCH_CONTROLLER_XPT2046, true, xpt2046_probe, xpt2046_init, xpt2046_read, xpt2046_get_task, xpt2046_get_time },
+#endif
+};
+
+static const touch_driver_entry_t *active;
+
+#if TOUCH_ASYNC
+#define ASYNC_STACK_SIZE    3072
+#define ASYNC_PERIOD        (CONFIG_LVGL_TOUCH_ASYNC_PERIOD_MS / portTICK_PERIOD_MS ? \
+                             CONFIG_LVGL_TOUCH_ASYNC_PERIOD_MS / portTICK_PERIOD_MS : 1)
+/* One slot stays empty to tell a full queue from an empty one */
+#define QUEUE_SLOTS         (CONFIG_LVGL_TOUCH_ASYNC_QUEUE_LEN + 1)
+
+typedef struct {
+    lv_point_t point;
+    lv_indev_state_t state;
+    uint8_t gesture;            /* FT6X36_GEST_ID_*, sent by the GUI task */
+    int64_t time;               /* acquisition [us] */
+} touch_sample_t;
+
+static void async_task(void *arg);
+static bool queue_push(const touch_sample_t *s);
+static bool queue_pop(touch_sample_t *s);
+static bool queue_empty(void);
+
+/* Single producer (async_task), single consumer (touch_driver_read).
+ * Each index is written by one side only, the acquire/release pairs
+ * order the slot contents against the index updates. */
+static touch_sample_t queue[QUEUE_SLOTS];
+static uint32_t queue_head;     /* next slot to write, owned by the producer */
+static uint32_t queue_tail;     /* next slot to read, owned by the consumer */
+static TaskHandle_t async_handle;
+static volatile uint32_t dropped;
+#endif
+
+static bool controller_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
+static int64_t controller_time(void);
+static uint8_t controller_gesture(void);
+static void send_gesture(uint8_t gesture);
+
+static BaseType_t task_core = TOUCH_TASK_DEFAULT_CORE;
+static UBaseType_t task_priority = TOUCH_TASK_DEFAULT_PRIORITY;
+static int64_t sample_time;
+
+/* With auto-detection the controller found first in drivers[] is used,
+ * otherwise the only entry. init_spi: false if the touch SPI device was
+ * already added to a shared bus with tp_spi_add_device(). */
+void touch_driver_init(bool init_spi)
+{
+    if (sizeof(drivers) == 0) return;
+
+#if CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_AUTO
+    bool spi_ready = !init_spi;
+    for (size_t i = 0; i < sizeof(drivers) / sizeof(drivers[0]) && !active; i++) {
+        const touch_driver_entry_t *d = &drivers[i];
+        if (d->spi) {
+            /* The bus is only set up once an SPI controller is probed */
+            if (!spi_ready) {
+                tp_spi_init();
+                spi_ready = true;
+            }
+            tp_spi_set_controller(d->controller);
+        }
+#if TOUCH_DRIVER_FT6X06
+        if (d->controller == TOUCH_CONTROLLER_FT6X06 && !i2c_pins_free()) continue;
+#endif
+        if (d->probe()) active = d;
+    }
+    if (!active) {
+        ESP_LOGE(TAG, "No touch controller found");
+        return;
+    }
+#else
+    active = &drivers[0];
+    if (active->spi && init_spi) {
+        tp_spi_init();
+    }
+#endif
+
+    ESP_LOGI(TAG, "Touch controller: %s", active->name);
+    active->init();
+
+#if TOUCH_ASYNC
+    BaseType_t ret = xTaskCreatePinnedToCore(async_task, "touch", ASYNC_STACK_SIZE, NULL,
+            task_priority, &async_handle, task_core);
+    assert(ret == pdPASS);
+#endif
+}
+
+bool touch_driver_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+#if TOUCH_ASYNC
+    /* Never touches the bus: hand over the next queued sample, or repeat
+     * the last one while the acquisition task has nothing new */
+    static touch_sample_t last = { .state = LV_INDEV_STATE_REL };
+
+    if (queue_pop(&last)) {
+        sample_time = last.time;
+        send_gesture(last.gesture);
+        last.gesture = FT6X36_GEST_ID_NO_GESTURE;
+#if TOUCH_PREDICT_ENABLED
+        /* Repeated samples carry no motion, only fresh ones are predicted */
+        touch_predict_apply(last.state == LV_INDEV_STATE_PR, last.time, &last.point.x, &last.point.y);
+#endif
+    }
+    data->point = last.point;
+    data->state = last.state;
+    return !queue_empty();
+#else
+    bool res = controller_read(drv, data);
+    sample_time = controller_time();
+    send_gesture(controller_gesture());
+#if TOUCH_PREDICT_ENABLED
+    touch_predict_apply(data->state == LV_INDEV_STATE_PR, sample_time, &data->point.x, &data->point.y);
+#endif
+    return res;
+#endif
+}
+
+/* Samples the acquisition task could not queue because LVGL fell behind */
+uint32_t touch_driver_get_dropped(void)
+{
+#if TOUCH_ASYNC
+    return dropped;
+#else
+    return 0;
+#endif
+}
+
+/* esp_timer time [us] the point last returned by touch_driver_read() was
+ * acquired at. Earlier than the read if it waited in a queue. */
+int64_t touch_driver_get_sample_time(void)
+{
+    return sample_time;
+}
+
+/* TOUCH_CONTROLLER_NONE until touch_driver_init() found a controller */
+uint8_t touch_driver_get_controller(void)
+{
+    return active ? active->controller : TOUCH_CONTROLLER_NONE;
+}
+
+static bool controller_read(lv_indev_drv_t *drv, lv_indev_data_t *data)
+{
+    if (!active) return false;
+    return active->read(drv, data);
+}
+
+/* Right after controller_read(), for the point it returned */
+static int64_t controller_time(void)
+{
+    return active && active->get_time ? active->get_time() : esp_timer_get_time();
+}
+
+/* Must be called before touch_driver_init() to affect the sampling task */
+void touch_driver_set_task_placement(BaseType_t core, UBaseType_t priority)
+{
+    task_core = core;
+    task_priority = priority;
+}
+
+BaseType_t touch_driver_get_task_core(void)
+{
+    return task_core;
+}
+
+UBaseType_t touch_driver_get_task_priority(void)
+{
+    return task_priority;
+}
+
+/* NULL when the controller is polled directly from touch_driver_read() */
+TaskHandle_t touch_driver_get_task(void)
+{
+#if TOUCH_ASYNC
+    return async_handle;
+#else
+    return active && active->get_task ? active->get_task() : NULL;
+#endif
+}
+
+#if TOUCH_DRIVER_FT6X06
+static bool ft6x36_probe_default(void)
+{
+    return ft6x36_probe(FT6236_I2C_SLAVE_ADDR);
+}
+
+static void ft6x36_init_default(void)
+{
+    ft6x36_init(FT6236_I2C_SLAVE_ADDR);
+}
+#endif
+
+#if TOUCH_DRIVER_FT6X06 && CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_AUTO
+/* Probing drives SDA and SCL. The defaults are left configured on boards
+ * without an FT6X36, where they can be display pins (SDA 21 is also the
+ * default backlight pin), so those are not probed. */
+static bool i2c_pins_free(void)
+{
+    static const int disp_pins[] = {
+        CONFIG_LVGL_DISP_SPI_MOSI, CONFIG_LVGL_DISP_SPI_CLK, CONFIG_LVGL_DISP_SPI_MISO,
+        CONFIG_LVGL_DISP_SPI_CS, CONFIG_LVGL_DISP_PIN_DC, CONFIG_LVGL_DISP_PIN_RST,
+#if CONFIG_LVGL_ENABLE_BACKLIGHT_CONTROL
+        CONFIG_LVGL_DISP_PIN_BCKL,
+#endif
+    };
+
+    for (size_t i = 0; i < sizeof(disp_pins) / sizeof(disp_pins[0]); i++) {
+        if (disp_pins[i] == CONFIG_LVGL_TOUCH_I2C_SDA || disp_pins[i] == CONFIG_LVGL_TOUCH_I2C_SCL) {
+            ESP_LOGW(TAG, "FT6X36 not probed, its I2C GPIO %d is a display pin", disp_pins[i]);
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+/* Taken in the task that reads the controller */
+static uint8_t controller_gesture(void)
+{
+#if TOUCH_DRIVER_FT6X06 && FT6X36_GESTURES
+    if (active && active->controller == TOUCH_CONTROLLER_FT6X06) return ft6x36_take_gesture();
+#endif
+    return FT6X36_GEST_ID_NO_GESTURE;
+}
+
+/* LVGL is not thread-safe, only called from the GUI task */
+static void send_gesture(uint8_t gesture)
+{
+    if (gesture != FT6X36_GEST_ID_NO_GESTURE) {
+        lv_event_send(lv_scr_act(), FT6X36_EVENT_GESTURE, &gesture);
+    }
+}
+
+#if TOUCH_ASYNC
+/* Owns the bus I/O of the controller. A slow or NACKing controller only
+ * delays this task, LVGL keeps getting the last known state. */
+static void async_task(void *arg)
+{
+    touch_sample_t pending;
+    bool has_pending = false;
+    lv_indev_state_t last_state = LV_INDEV_STATE_REL;
+    TickType_t wake = xTaskGetTickCount();
+
+    ESP_LOGI(TAG, "Acquisition task every %u ms, %u samples queued",
+             CONFIG_LVGL_TOUCH_ASYNC_PERIOD_MS, CONFIG_LVGL_TOUCH_ASYNC_QUEUE_LEN);
+
+    while (1) {
+        bool more;
+        do {
+            lv_indev_data_t data = { .state = LV_INDEV_STATE_REL };
+            more = controller_read(NULL, &data);
+            int64_t time = controller_time();
+            uint8_t gesture = controller_gesture();
+
+            /* Releases are only queued once, LVGL repeats the last state */
+            if (data.state == LV_INDEV_STATE_REL && last_state == LV_INDEV_STATE_REL &&
+                gesture == FT6X36_GEST_ID_NO_GESTURE) continue;
+            last_state = data.state;
+
+            /* While the queue is full only the newest sample waits, a
+             * gesture of the replaced one is kept */
+            if (has_pending) dropped++;
+            else pending.gesture = FT6X36_GEST_ID_NO_GESTURE;
+            pending.point = data.point;
+            pending.state = data.state;
+            pending.time = time;
+            if (gesture != FT6X36_GEST_ID_NO_GESTURE) pending.gesture = gesture;
+            has_pending = true;
+            if (queue_push(&pending)) has_pending = false;
+        } while (more);
+
+        if (has_pending && queue_push(&pending)) has_pending = false;
+
+        vTaskDelayUntil(&wake, ASYNC_PERIOD);
+    }
+}
+
+static bool queue_push(const touch_sample_t *s)
+{
+    uint32_t head = __atomic_load_n(&queue_head, __ATOMIC_RELAXED);
+    uint32_t next = head + 1 == QUEUE_SLOTS ? 0 : head + 1;
+
+    if (next == __atomic_load_n(&queue_tail, __ATOMIC_ACQUIRE)) return false;
+
+    queue[head] = *s;
+    __atomic_store_n(&queue_head, next, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool queue_pop(touch_sample_t *s)
+{
+    uint32_t tail = __atomic_load_n(&queue_tail, __ATOMIC_RELAXED);
+
+    if (tail == __atomic_load_n(&queue_head, __ATOMIC_ACQUIRE)) return false;
+
+    *s = queue[tail];
+    __atomic_store_n(&queue_tail, tail + 1 == QUEUE_SLOTS ? 0 : tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool queue_empty(void)
+{
+    return __atomic_load_n(&queue_tail, __ATOMIC_RELAXED) ==
+           __atomic_load_n(&queue_head, __ATOMIC_ACQUIRE);
+}
+#endif
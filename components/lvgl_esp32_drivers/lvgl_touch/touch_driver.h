@@ -1,42 +1,64 @@
-/**
- * @file touch_driver.h
- */
-
-#ifndef TOUCH_DRIVER_H
-#define TOUCH_DRIVER_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*********************
- *      INCLUDES
- *********************/
-#include <stdint.h>
-#include <stdbool.h>
-#include "lvgl/lvgl.h"
-#include "xpt2046.h"
-#include "ft6x36.h"
-#include "stmpe610.h"
-
-/*********************
-*      DEFINES
-*********************/
-/* Add a new define entry at the end for new controllers */
-#define TOUCH_CONTROLLER_NONE	    0
-#define TOUCH_CONTROLLER_XPT2046    1
-#define TOUCH_CONTROLLER_FT6X06	    2
-#define TOUCH_CONTROLLER_STMPE610   3
-
-/**********************
- * GLOBAL PROTOTYPES
- **********************/
-void touch_driver_init(bool init_spi);
-bool touch_driver_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
-
-#ifdef __cplusplus
-} /* extern "C" */
-#endif
-
-#endif /* TOUCH_DRIVER_H */
-
+/**
+ * @file touch_driver.h
+ */
+
+#ifndef TOUCH_DRIVER_H
+#define TOUCH_DRIVER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lvgl/lvgl.h"
+#include "xpt2046.h"
+#include "ft6x36.h"
+#include "stmpe610.h"
+
+/*********************
+*      DEFINES
+*********************/
+/* Add a new define entry at the end for new controllers */
+#define TOUCH_CONTROLLER_NONE	    0
+#define TOUCH_CONTROLLER_XPT2046    1
+#define TOUCH_CONTROLLER_FT6X06	    2
+#define TOUCH_CONTROLLER_STMPE610   3
+#define TOUCH_CONTROLLER_AUTO       4   /* probe for any of the above */
+
+/* Drivers built into the image, all of them with auto-detection */
+#define TOUCH_DRIVER_XPT2046        CONFIG_LVGL_TOUCH_DRIVER_XPT2046
+#define TOUCH_DRIVER_FT6X06         CONFIG_LVGL_TOUCH_DRIVER_FT6X06
+#define TOUCH_DRIVER_STMPE610       CONFIG_LVGL_TOUCH_DRIVER_STMPE610
+
+/* Placement of driver owned sampling tasks unless set by the application */
+#define TOUCH_TASK_DEFAULT_CORE     tskNO_AFFINITY
+#define TOUCH_TASK_DEFAULT_PRIORITY 5
+
+/* Bus I/O in a driver owned task, touch_driver_read() only dequeues */
+#define TOUCH_ASYNC                 CONFIG_LVGL_TOUCH_ASYNC
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void touch_driver_init(bool init_spi);
+bool touch_driver_read(lv_indev_drv_t *drv, lv_indev_data_t *data);
+void touch_driver_set_task_placement(BaseType_t core, UBaseType_t priority);
+BaseType_t touch_driver_get_task_core(void);
+UBaseType_t touch_driver_get_task_priority(void);
+TaskHandle_t touch_driver_get_task(void);
+uint8_t touch_driver_get_controller(void);
+uint32_t touch_driver_get_dropped(void);
+int64_t touch_driver_get_sample_time(void);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TOUCH_DRIVER_H */
+
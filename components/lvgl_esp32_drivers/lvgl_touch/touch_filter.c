@@ -0,0 +1,198 @@
+/**
+ * @file touch_filter.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_filter.h"
+#include <stdlib.h>
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SPEED_FRAC  4
+#define SPEED_SHIFT 2       /*Each sample weighs 1/4 in the averaged speed*/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void median_stage(touch_filter_t * f, int16_t * x, int16_t * y);
+static void avg_stage(touch_filter_t * f, int16_t * x, int16_t * y);
+static void iir_stage(touch_filter_t * f, int16_t * x, int16_t * y);
+static int16_t median_of(const int16_t * v, uint8_t n);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize a filter. Out of range window sizes are clamped.
+ * @param f the filter
+ * @param cfg configuration, usually TOUCH_FILTER_CFG(<controller>)
+ */
+void touch_filter_init(touch_filter_t * f, const touch_filter_cfg_t * cfg)
+{
+    memset(f, 0, sizeof(touch_filter_t));
+    f->cfg = *cfg;
+
+    if(f->cfg.median < 1) f->cfg.median = 1;
+    if(f->cfg.median > TOUCH_FILTER_MEDIAN_MAX) f->cfg.median = TOUCH_FILTER_MEDIAN_MAX;
+    if(f->cfg.avg < 1) f->cfg.avg = 1;
+    if(f->cfg.avg > TOUCH_FILTER_AVG_MAX) f->cfg.avg = TOUCH_FILTER_AVG_MAX;
+    if(f->cfg.iir_shift > 8) f->cfg.iir_shift = 8;
+}
+
+/**
+ * Forget the history so the next press starts unfiltered.
+ * The last reported position is kept.
+ * @param f the filter
+ */
+void touch_filter_reset(touch_filter_t * f)
+{
+    f->med_cnt = 0;
+    f->med_idx = 0;
+    f->avg_cnt = 0;
+    f->avg_idx = 0;
+    f->sum_x = 0;
+    f->sum_y = 0;
+    f->speed = 0;
+    f->release_cnt = 0;
+    f->down = false;
+}
+
+/**
+ * Pass one read through the filter.
+ * @param f the filter
+ * @param pressed state reported by the controller
+ * @param x the raw x coordinate when pressed, replaced by the filtered one
+ * @param y the raw y coordinate when pressed, replaced by the filtered one
+ * @return the state to report to LVGL
+ */
+bool touch_filter_apply(touch_filter_t * f, bool pressed, int16_t * x, int16_t * y)
+{
+    if(!pressed) {
+        /*Hold short dropouts as pressed at the last position*/
+        if(f->down && f->release_cnt < f->cfg.debounce) {
+            f->release_cnt++;
+        } else if(f->down) {
+            touch_filter_reset(f);
+        }
+
+        *x = f->out_x;
+        *y = f->out_y;
+        return f->down;
+    }
+
+    bool first = !f->down;
+    f->down = true;
+    f->release_cnt = 0;
+
+    int16_t fx = *x;
+    int16_t fy = *y;
+    median_stage(f, &fx, &fy);
+    avg_stage(f, &fx, &fy);
+    if(first) {
+        f->iir_x = (int32_t)fx << 8;
+        f->iir_y = (int32_t)fy << 8;
+        f->in_x = fx;
+        f->in_y = fy;
+    }
+    iir_stage(f, &fx, &fy);
+
+    /*A new press always moves, within a press small moves are jitter*/
+    if(first || abs(fx - f->out_x) > f->cfg.deadband || abs(fy - f->out_y) > f->cfg.deadband) {
+        f->out_x = fx;
+        f->out_y = fy;
+    }
+
+    *x = f->out_x;
+    *y = f->out_y;
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Median of the last cfg.median samples, rejects single sample spikes */
+static void median_stage(touch_filter_t * f, int16_t * x, int16_t * y)
+{
+    if(f->cfg.median <= 1) return;
+
+    f->med_x[f->med_idx] = *x;
+    f->med_y[f->med_idx] = *y;
+    f->med_idx = (f->med_idx + 1) % f->cfg.median;
+    if(f->med_cnt < f->cfg.median) f->med_cnt++;
+
+    *x = median_of(f->med_x, f->med_cnt);
+    *y = median_of(f->med_y, f->med_cnt);
+}
+
+/* Average of the last cfg.avg samples with a running sum */
+static void avg_stage(touch_filter_t * f, int16_t * x, int16_t * y)
+{
+    if(f->cfg.avg <= 1) return;
+
+    if(f->avg_cnt == f->cfg.avg) {
+        f->sum_x -= f->avg_x[f->avg_idx];
+        f->sum_y -= f->avg_y[f->avg_idx];
+    } else {
+        f->avg_cnt++;
+    }
+
+    f->avg_x[f->avg_idx] = *x;
+    f->avg_y[f->avg_idx] = *y;
+    f->sum_x += *x;
+    f->sum_y += *y;
+    f->avg_idx = (f->avg_idx + 1) % f->cfg.avg;
+
+    *x = f->sum_x / f->avg_cnt;
+    *y = f->sum_y / f->avg_cnt;
+}
+
+/* Exponential smoothing. With cfg.adapt the weight of new samples grows
+ * with the speed of the pen (one euro filter): still pens are smoothed
+ * hard, fast strokes follow with little lag. */
+static void iir_stage(touch_filter_t * f, int16_t * x, int16_t * y)
+{
+    if(f->cfg.iir_shift == 0) return;
+
+    int32_t w = 256 >> f->cfg.iir_shift;
+
+    if(f->cfg.adapt) {
+        int32_t d = abs(*x - f->in_x);
+        int32_t dy = abs(*y - f->in_y);
+        if(dy > d) d = dy;
+        f->speed += ((d << SPEED_FRAC) - f->speed) / (1 << SPEED_SHIFT);
+
+        w += (f->speed * f->cfg.adapt) >> SPEED_FRAC;
+        if(w > 256) w = 256;
+    }
+    f->in_x = *x;
+    f->in_y = *y;
+
+    f->iir_x += (((int32_t)*x << 8) - f->iir_x) * w / 256;
+    f->iir_y += (((int32_t)*y << 8) - f->iir_y) * w / 256;
+
+    *x = (f->iir_x + 128) >> 8;
+    *y = (f->iir_y + 128) >> 8;
+}
+
+static int16_t median_of(const int16_t * v, uint8_t n)
+{
+    int16_t s[TOUCH_FILTER_MEDIAN_MAX];
+    memcpy(s, v, n * sizeof(int16_t));
+
+    for(uint8_t i = 1; i < n; i++) {
+        int16_t t = s[i];
+        uint8_t j = i;
+        for(; j > 0 && s[j - 1] > t; j--) s[j] = s[j - 1];
+        s[j] = t;
+    }
+
+    if(n & 1) return s[n / 2];
+    return (s[n / 2 - 1] + s[n / 2]) / 2;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file touch_filter.h
+ *
+ * Smoothing shared by the touch controller drivers: median pre-filter,
+ * running average, optional speed adaptive IIR, deadband and release
+ * debouncing. Every stage has a constant cost per sample.
+ */
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_FILTER_MEDIAN_MAX 5
+#define TOUCH_FILTER_AVG_MAX    16
+
+/* Configuration of a controller from its LVGL_TOUCH_<ctrl>_FILTER_* options */
+#define TOUCH_FILTER_CFG(ctrl) {                                \
+    .median = CONFIG_LVGL_TOUCH_##ctrl##_FILTER_MEDIAN,         \
+    .avg = CONFIG_LVGL_TOUCH_##ctrl##_FILTER_AVG,               \
+    .iir_shift = CONFIG_LVGL_TOUCH_##ctrl##_FILTER_IIR_SHIFT,   \
+    .adapt = CONFIG_LVGL_TOUCH_##ctrl##_FILTER_ADAPT,           \
+    .deadband = CONFIG_LVGL_TOUCH_##ctrl##_FILTER_DEADBAND,     \
+    .debounce = CONFIG_LVGL_TOUCH_##ctrl##_FILTER_DEBOUNCE,     \
+}
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint8_t median;     /*Median window [samples], 1: off*/
+    uint8_t avg;        /*Running average window [samples], 1: off*/
+    uint8_t iir_shift;  /*New samples weigh 1/2^iir_shift, 0: off*/
+    uint8_t adapt;      /*Extra IIR weight per px/sample of speed [1/256], 0: fixed weight*/
+    uint8_t deadband;   /*Moves up to this distance are ignored [px]*/
+    uint8_t debounce;   /*Released reads held as pressed before reporting a release*/
+} touch_filter_cfg_t;
+
+typedef struct {
+    touch_filter_cfg_t cfg;
+
+    int16_t med_x[TOUCH_FILTER_MEDIAN_MAX];
+    int16_t med_y[TOUCH_FILTER_MEDIAN_MAX];
+    uint8_t med_cnt;
+    uint8_t med_idx;
+
+    int16_t avg_x[TOUCH_FILTER_AVG_MAX];
+    int16_t avg_y[TOUCH_FILTER_AVG_MAX];
+    int32_t sum_x;
+    int32_t sum_y;
+    uint8_t avg_cnt;
+    uint8_t avg_idx;
+
+    int32_t iir_x;      /*[px << 8]*/
+    int32_t iir_y;
+    int16_t in_x;       /*Previous IIR input*/
+    int16_t in_y;
+    int32_t speed;      /*Averaged [px/sample << 4]*/
+
+    int16_t out_x;
+    int16_t out_y;
+    uint8_t release_cnt;
+    bool down;
+} touch_filter_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void touch_filter_init(touch_filter_t * f, const touch_filter_cfg_t * cfg);
+void touch_filter_reset(touch_filter_t * f);
+bool touch_filter_apply(touch_filter_t * f, bool pressed, int16_t * x, int16_t * y);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TOUCH_FILTER_H*/
@@ -0,0 +1,168 @@
+/**
+ * @file touch_predict.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_predict.h"
+
+#if TOUCH_PREDICT_ENABLED
+
+#include <stdlib.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MAX_OFFSET      CONFIG_LVGL_TOUCH_PREDICT_MAX_PX
+#define FRAC            16      /*Fractional bits of velocity and acceleration*/
+#define VEL_SHIFT       1       /*Each sample weighs 1/2 in the velocity*/
+#define ACC_SHIFT       2       /*and 1/4 in the acceleration*/
+#define MAX_DT          100000  /*Older history is stale, start over [us]*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int32_t pos;        /*Last input [px]*/
+    int32_t vel;        /*[px/ms << FRAC]*/
+    int32_t acc;        /*[px/ms^2 << FRAC]*/
+} axis_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void axis_update(axis_t * a, int16_t p, int32_t dt_us, uint8_t n);
+static int16_t axis_predict(const axis_t * a, int32_t h, int16_t max);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static axis_t ax;
+static axis_t ay;
+static int64_t last_t;
+static uint8_t n;               /*Samples seen since the press, saturates at 3*/
+static volatile uint32_t horizon = CONFIG_LVGL_TOUCH_PREDICT_HORIZON_MS;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Forget the motion history, the next point is reported as is.
+ */
+void touch_predict_reset(void)
+{
+    n = 0;
+}
+
+/**
+ * Extrapolate a point to where the finger will be after the horizon.
+ * Releases and the first samples of a press are passed through unchanged.
+ * @param pressed state of the sample
+ * @param time acquisition time of the sample [us], a repeated sample keeps it
+ * @param x x coordinate [px], replaced by the predicted one
+ * @param y y coordinate [px], replaced by the predicted one
+ */
+void touch_predict_apply(bool pressed, int64_t time, int16_t * x, int16_t * y)
+{
+    if(!pressed) {
+        /*The release must be where the finger really left*/
+        n = 0;
+        return;
+    }
+
+    int64_t dt = time - last_t;
+
+    if(n > 0 && dt > MAX_DT) n = 0;
+    if(n > 0 && dt <= 0) {
+        /*Repeated sample, keep the motion state*/
+        *x = axis_predict(&ax, horizon, LV_HOR_RES);
+        *y = axis_predict(&ay, horizon, LV_VER_RES);
+        return;
+    }
+
+    axis_update(&ax, *x, (int32_t)dt, n);
+    axis_update(&ay, *y, (int32_t)dt, n);
+    last_t = time;
+    if(n < 3) n++;
+
+    /*Velocity needs 2 samples, acceleration 3*/
+    if(n < 2) return;
+
+    *x = axis_predict(&ax, horizon, LV_HOR_RES);
+    *y = axis_predict(&ay, horizon, LV_VER_RES);
+}
+
+/**
+ * Set how far ahead to predict, e.g. the measured touch-to-photon latency.
+ * @param ms the horizon [ms], clamped to TOUCH_PREDICT_HORIZON_MAX
+ */
+void touch_predict_set_horizon(uint32_t ms)
+{
+    horizon = ms > TOUCH_PREDICT_HORIZON_MAX ? TOUCH_PREDICT_HORIZON_MAX : ms;
+}
+
+/**
+ * @return the prediction horizon [ms]
+ */
+uint32_t touch_predict_get_horizon(void)
+{
+    return horizon;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void axis_update(axis_t * a, int16_t p, int32_t dt_us, uint8_t n)
+{
+    if(n == 0) {
+        a->pos = p;
+        a->vel = 0;
+        a->acc = 0;
+        return;
+    }
+
+    int32_t v = (int32_t)(((int64_t)(p - a->pos) << FRAC) * 1000 / dt_us);
+    int32_t dv;
+    if(n == 1) {
+        dv = 0;
+        a->vel = v;
+    } else {
+        int32_t vel_old = a->vel;
+        a->vel += (v - a->vel) >> VEL_SHIFT;
+        dv = a->vel - vel_old;
+    }
+
+    if(n >= 2) {
+        int32_t acc = (int32_t)((int64_t)dv * 1000 / dt_us);
+        a->acc += (acc - a->acc) >> ACC_SHIFT;
+    }
+
+    a->pos = p;
+}
+
+/* pos + v * h + a * h^2 / 2, the acceleration term may slow the point
+ * down to the last input but not reverse it, the offset is limited to
+ * MAX_OFFSET and the result kept on the screen */
+static int16_t axis_predict(const axis_t * a, int32_t h, int16_t max)
+{
+    int64_t lin = (int64_t)a->vel * h;
+    int64_t quad = (int64_t)a->acc * h * h / 2;
+
+    if((lin >= 0 && quad < -lin) || (lin < 0 && quad > -lin)) quad = -lin;
+
+    int32_t off = (int32_t)((lin + quad) >> FRAC);
+    if(off > MAX_OFFSET) off = MAX_OFFSET;
+    if(off < -MAX_OFFSET) off = -MAX_OFFSET;
+
+    int32_t p = a->pos + off;
+    if(p < 0) p = 0;
+    if(p > max - 1) p = max - 1;
+    return (int16_t)p;
+}
+
+#endif /*TOUCH_PREDICT_ENABLED*/
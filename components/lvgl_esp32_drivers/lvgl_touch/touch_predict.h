@@ -0,0 +1,45 @@
+/**
+ * @file touch_predict.h
+ *
+ * Drag prediction: extrapolates the reported point by the pipeline latency
+ * from the velocity and acceleration of the recent samples so that dragged
+ * objects do not trail the finger.
+ */
+
+#ifndef TOUCH_PREDICT_H
+#define TOUCH_PREDICT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_PREDICT_ENABLED   CONFIG_LVGL_TOUCH_PREDICT
+#define TOUCH_PREDICT_HORIZON_MAX 100   /*[ms]*/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void touch_predict_reset(void);
+void touch_predict_apply(bool pressed, int64_t time, int16_t * x, int16_t * y);
+void touch_predict_set_horizon(uint32_t ms);
+uint32_t touch_predict_get_horizon(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TOUCH_PREDICT_H*/
@@ -1,136 +1,286 @@
-/**
- * @file tp_spi.c
- *
- */
-
-/*********************
- *      INCLUDES
- *********************/
-#include "tp_spi.h"
-#include "touch_driver.h"
-#include "esp_system.h"
-#include "driver/gpio.h"
-#include "driver/spi_master.h"
-#include <string.h>
-
-/*********************
- *      DEFINES
- *********************/
-#if CONFIG_LVGL_TOUCH_CONTROLLER_SPI_HSPI == 1
-#define TOUCH_SPI_HOST HSPI_HOST
-#else
-#define TOUCH_SPI_HOST VSPI_HOST
-#endif
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-
-/**********************
- *  STATIC PROTOTYPES
- **********************/
-static spi_device_handle_t spi;
-
-/**********************
- *  STATIC VARIABLES
- **********************/
-
-/**********************
- *      MACROS
- **********************/
-
-/**********************
- *   GLOBAL FUNCTIONS
- **********************/
-void tp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg)
-{
-	esp_err_t ret=spi_bus_add_device(host, devcfg, &spi);
-	assert(ret==ESP_OK);
-}
-
-void tp_spi_add_device(spi_host_device_t host)
-{
-	spi_device_interface_config_t devcfg={
-#if CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_STMPE610
-		.clock_speed_hz=1*1000*1000,           //Clock out at 1 MHz
-		.mode=1,                               //SPI mode 1
-#else
-		.clock_speed_hz=2*1000*1000,           //Clock out at 2 MHz
-		.mode=0,                               //SPI mode 0
-#endif
-		.spics_io_num=TP_SPI_CS,               //CS pin
-		.queue_size=1,
-		.pre_cb=NULL,
-		.post_cb=NULL,
-		.command_bits = 8,
-		.address_bits = 0,
-		.dummy_bits = 0,
-		.flags = SPI_DEVICE_HALFDUPLEX | SPI_DEVICE_NO_DUMMY,
-	};
-	
-	//Attach the Touch controller to the SPI bus
-	tp_spi_add_device_config(host, &devcfg);
-}
-
-void tp_spi_init(void)
-{
-	esp_err_t ret;
-
-	spi_bus_config_t buscfg={
-		.miso_io_num=TP_SPI_MISO,
-		.mosi_io_num=TP_SPI_MOSI,
-		.sclk_io_num=TP_SPI_CLK,
-		.quadwp_io_num=-1,
-		.quadhd_io_num=-1
-	};
-
-	//Initialize the SPI bus
-	ret=spi_bus_initialize(TOUCH_SPI_HOST, &buscfg, 2);
-	assert(ret==ESP_OK);
-
-	//Attach the Touch controller to the SPI bus
-	tp_spi_add_device(TOUCH_SPI_HOST);
-}
-
-void tp_spi_xchg(uint8_t* data_send, uint8_t* data_recv, uint8_t byte_count)
-{
-	spi_transaction_t t = {
-		.length = byte_count * 8, // SPI transaction length is in bits
-		.tx_buffer = data_send,
-		.rx_buffer = data_recv};
-	
-	esp_err_t ret = spi_device_transmit(spi, &t);
-	assert(ret == ESP_OK);
-}
-
-void tp_spi_write_reg(uint8_t* data, uint8_t byte_count)
-{
-	spi_transaction_t t = {
-	    .length = byte_count * 8,
-	    .tx_buffer = data,
-	    .flags = 0
-	};
-	
-	esp_err_t ret = spi_device_transmit(spi, &t);
-	assert(ret == ESP_OK);
-}
-
-void tp_spi_read_reg(uint8_t reg, uint8_t* data, uint8_t byte_count)
-{
-	spi_transaction_t t = {	
-	    .length = (byte_count + sizeof(reg)) * 8,
-	    .rxlength = byte_count * 8,
-	    .cmd = reg,
-	    .rx_buffer = data,
-	    .flags = 0
-	};
-	
-	// Read - send first byte as command
-	esp_err_t ret = spi_device_transmit(spi, &t);
-	assert(ret == ESP_OK);
-}
-
-/**********************
- *   STATIC FUNCTIONS
- **********************/
+/**
+ * @file tp_spi.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "tp_spi.h"
+#include "touch_driver.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#if CONFIG_LVGL_TOUCH_CONTROLLER_SPI_HSPI == 1
+#define TOUCH_SPI_HOST HSPI_HOST
+#else
+#define TOUCH_SPI_HOST VSPI_HOST
+#endif
+
+/* Transfers up to this size go through tx_data/rx_data and are polled,
+ * longer ones need DMA capable buffers and wait for the interrupt */
+#define POLL_MAX_BYTES  4
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void fill_devcfg(uint8_t controller, spi_device_interface_config_t *devcfg);
+static void transmit(spi_transaction_t *t, bool poll);
+static void count_wait(int64_t start);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static spi_device_handle_t spi;
+static spi_host_device_t spi_host;
+/* Auto-detection probes the STMPE610 first, see touch_driver_init() */
+static uint8_t spi_controller = CONFIG_LVGL_TOUCH_CONTROLLER == TOUCH_CONTROLLER_AUTO ?
+		TOUCH_CONTROLLER_STMPE610 : CONFIG_LVGL_TOUCH_CONTROLLER;
+static bool bus_acquired;
+static portMUX_TYPE stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static tp_spi_stats_t stats;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void tp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *devcfg)
+{
+	esp_err_t ret=spi_bus_add_device(host, devcfg, &spi);
+	assert(ret==ESP_OK);
+	spi_host = host;
+}
+
+void tp_spi_add_device(spi_host_device_t host)
+{
+	spi_device_interface_config_t devcfg;
+	fill_devcfg(spi_controller, &devcfg);
+
+	//Attach the Touch controller to the SPI bus
+	tp_spi_add_device_config(host, &devcfg);
+}
+
+/**
+ * Select the controller the SPI device is configured for (mode, clock,
+ * duplex). An already attached device is replaced on the same bus.
+ * @param controller TOUCH_CONTROLLER_XPT2046 or TOUCH_CONTROLLER_STMPE610
+ */
+void tp_spi_set_controller(uint8_t controller)
+{
+	if (controller == spi_controller) return;
+	spi_controller = controller;
+
+	if (spi) {
+		esp_err_t ret = spi_bus_remove_device(spi);
+		assert(ret == ESP_OK);
+		spi = NULL;
+		tp_spi_add_device(spi_host);
+	}
+}
+
+void tp_spi_init(void)
+{
+	esp_err_t ret;
+
+	spi_bus_config_t buscfg={
+		.miso_io_num=TP_SPI_MISO,
+		.mosi_io_num=TP_SPI_MOSI,
+		.sclk_io_num=TP_SPI_CLK,
+		.quadwp_io_num=-1,
+		.quadhd_io_num=-1
+	};
+
+	//Initialize the SPI bus
+	ret=spi_bus_initialize(TOUCH_SPI_HOST, &buscfg, 2);
+	assert(ret==ESP_OK);
+
+	//Attach the Touch controller to the SPI bus
+	tp_spi_add_device(TOUCH_SPI_HOST);
+}
+
+void tp_spi_xchg(uint8_t* data_send, uint8_t* data_recv, uint8_t byte_count)
+{
+	spi_transaction_t t = {
+		.length = byte_count * 8, // SPI transaction length is in bits
+		.tx_buffer = data_send,
+		.rx_buffer = data_recv};
+	
+	if (byte_count <= POLL_MAX_BYTES) {
+		t.flags = SPI_TRANS_USE_TXDATA | SPI_TRANS_USE_RXDATA;
+		memcpy(t.tx_data, data_send, byte_count);
+		transmit(&t, true);
+		memcpy(data_recv, t.rx_data, byte_count);
+	} else {
+		transmit(&t, false);
+	}
+}
+
+void tp_spi_write_reg(uint8_t* data, uint8_t byte_count)
+{
+	spi_transaction_t t = {
+	    .length = byte_count * 8,
+	    .tx_buffer = data,
+	    .flags = 0
+	};
+	
+	if (byte_count <= POLL_MAX_BYTES) {
+		t.flags = SPI_TRANS_USE_TXDATA;
+		memcpy(t.tx_data, data, byte_count);
+	}
+	transmit(&t, byte_count <= POLL_MAX_BYTES);
+}
+
+void tp_spi_read_reg(uint8_t reg, uint8_t* data, uint8_t byte_count)
+{
+	spi_transaction_t t = {	
+	    .length = (byte_count + sizeof(reg)) * 8,
+	    .rxlength = byte_count * 8,
+	    .cmd = reg,
+	    .rx_buffer = data,
+	    .flags = 0
+	};
+	
+	// Read - send first byte as command
+	if (byte_count <= POLL_MAX_BYTES) {
+		t.flags = SPI_TRANS_USE_RXDATA;
+		transmit(&t, true);
+		memcpy(data, t.rx_data, byte_count);
+	} else {
+		transmit(&t, false);
+	}
+}
+
+/**
+ * Read a list of 8 bit registers, polled one after the other in a single
+ * bus acquisition.
+ * @param regs reg: command byte as passed to tp_spi_read_reg(), val: store the value here
+ * @param count number of registers
+ */
+void tp_spi_read_regs(tp_spi_reg_t *regs, uint8_t count)
+{
+	bool own = !bus_acquired;
+	if (own) tp_spi_acquire_bus();
+
+	for (uint8_t i = 0; i < count; i++) {
+		tp_spi_read_reg(regs[i].reg, &regs[i].val, 1);
+	}
+
+	if (own) tp_spi_release_bus();
+}
+
+/**
+ * Write a list of 8 bit registers, polled one after the other in a single
+ * bus acquisition.
+ * @param regs the register addresses and values, in write order
+ * @param count number of registers
+ */
+void tp_spi_write_regs(const tp_spi_reg_t *regs, uint8_t count)
+{
+	bool own = !bus_acquired;
+	if (own) tp_spi_acquire_bus();
+
+	for (uint8_t i = 0; i < count; i++) {
+		uint8_t data[2] = {regs[i].reg, regs[i].val};
+		tp_spi_write_reg(data, 2);
+	}
+
+	if (own) tp_spi_release_bus();
+}
+
+/**
+ * Keep the bus for a sequence of transactions, e.g. draining a FIFO.
+ * On a shared bus the display waits meanwhile, so keep it short.
+ * Waits for the transaction of the other device in flight.
+ */
+void tp_spi_acquire_bus(void)
+{
+	int64_t start = esp_timer_get_time();
+
+	esp_err_t ret = spi_device_acquire_bus(spi, portMAX_DELAY);
+	assert(ret == ESP_OK);
+	bus_acquired = true;
+
+	count_wait(start);
+}
+
+void tp_spi_release_bus(void)
+{
+	bus_acquired = false;
+	spi_device_release_bus(spi);
+}
+
+/**
+ * Get the time the touch transactions waited for the bus, up to the
+ * acquisition. The transfers themselves are not counted.
+ * @param stats_out store the counters here
+ * @param reset start counting from zero
+ */
+void tp_spi_get_stats(tp_spi_stats_t *stats_out, bool reset)
+{
+	portENTER_CRITICAL(&stats_mux);
+	*stats_out = stats;
+	if (reset) memset(&stats, 0, sizeof(stats));
+	portEXIT_CRITICAL(&stats_mux);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static void fill_devcfg(uint8_t controller, spi_device_interface_config_t *devcfg)
+{
+	memset(devcfg, 0, sizeof(*devcfg));
+	devcfg->spics_io_num = TP_SPI_CS;              //CS pin
+	devcfg->queue_size = 1;
+
+	if (controller == TOUCH_CONTROLLER_STMPE610) {
+		devcfg->clock_speed_hz = 1*1000*1000;      //Clock out at 1 MHz
+		devcfg->mode = 1;                          //SPI mode 1
+		devcfg->command_bits = 8;
+		devcfg->flags = SPI_DEVICE_HALFDUPLEX | SPI_DEVICE_NO_DUMMY;
+	} else {
+		devcfg->clock_speed_hz = 2*1000*1000;      //Clock out at 2 MHz
+		devcfg->mode = 0;                          //SPI mode 0
+		devcfg->command_bits = 0;                  //Commands are chained inside tp_spi_xchg() frames
+		devcfg->flags = 0;                         //Full duplex
+	}
+}
+
+/* Polled transactions busy-wait for the transfer instead of sleeping
+ * until the interrupt, cheaper for a few bytes. The bus is acquired
+ * first, so the statistics count the wait for it without the transfer. */
+static void transmit(spi_transaction_t *t, bool poll)
+{
+	bool own = !bus_acquired;
+	if (own) tp_spi_acquire_bus();
+
+	esp_err_t ret = poll ? spi_device_polling_transmit(spi, t) : spi_device_transmit(spi, t);
+	assert(ret == ESP_OK);
+
+	if (own) tp_spi_release_bus();
+}
+
+static void count_wait(int64_t start)
+{
+	uint32_t us = esp_timer_get_time() - start;
+
+	portENTER_CRITICAL(&stats_mux);
+	stats.count++;
+	stats.total_us += us;
+	if (us > stats.max_us) stats.max_us = us;
+	portEXIT_CRITICAL(&stats_mux);
+}
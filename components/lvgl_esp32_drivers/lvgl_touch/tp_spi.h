@@ -1,54 +1,72 @@
-/**
- * @file tp_spi.h
- *
- */
-
-#ifndef TP_SPI_H
-#define TP_SPI_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*********************
- *      INCLUDES
- *********************/
-#include <stdint.h>
-#include <driver/spi_master.h>
-
-/*********************
- *      DEFINES
- *********************/
-
-#define ENABLE_TOUCH_INPUT  CONFIG_LVGL_ENABLE_TOUCH
-
-#define TP_SPI_MOSI CONFIG_LVGL_TOUCH_SPI_MOSI
-#define TP_SPI_MISO CONFIG_LVGL_TOUCH_SPI_MISO
-#define TP_SPI_CLK  CONFIG_LVGL_TOUCH_SPI_CLK
-#define TP_SPI_CS   CONFIG_LVGL_TOUCH_SPI_CS
-
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-/**********************
- * GLOBAL PROTOTYPES
- **********************/
-void tp_spi_init(void);
-void tp_spi_add_device(spi_host_device_t host);
-void tp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *config);
-void tp_spi_xchg(uint8_t* data_send, uint8_t* data_recv, uint8_t byte_count);
-void tp_spi_write_reg(uint8_t* data, uint8_t byte_count);
-void tp_spi_read_reg(uint8_t reg, uint8_t* data, uint8_t byte_count);
-
-/**********************
- *      MACROS
- **********************/
-
-
-#ifdef __cplusplus
-} /* extern "C" */
-#endif
-
-#endif /*TP_SPI_H*/
+/**
+ * @file tp_spi.h
+ *
+ */
+
+#ifndef TP_SPI_H
+#define TP_SPI_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <driver/spi_master.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+#define ENABLE_TOUCH_INPUT  CONFIG_LVGL_ENABLE_TOUCH
+
+#define TP_SPI_MOSI CONFIG_LVGL_TOUCH_SPI_MOSI
+#define TP_SPI_MISO CONFIG_LVGL_TOUCH_SPI_MISO
+#define TP_SPI_CLK  CONFIG_LVGL_TOUCH_SPI_CLK
+#define TP_SPI_CS   CONFIG_LVGL_TOUCH_SPI_CS
+
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* Time spent waiting for the bus, including the own transfer (a few us) */
+typedef struct {
+	uint32_t count;         /* bus acquisitions */
+	uint32_t total_us;
+	uint32_t max_us;
+} tp_spi_stats_t;
+
+typedef struct {
+	uint8_t reg;
+	uint8_t val;
+} tp_spi_reg_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void tp_spi_init(void);
+void tp_spi_add_device(spi_host_device_t host);
+void tp_spi_add_device_config(spi_host_device_t host, spi_device_interface_config_t *config);
+void tp_spi_set_controller(uint8_t controller);
+void tp_spi_xchg(uint8_t* data_send, uint8_t* data_recv, uint8_t byte_count);
+void tp_spi_write_reg(uint8_t* data, uint8_t byte_count);
+void tp_spi_read_reg(uint8_t reg, uint8_t* data, uint8_t byte_count);
+void tp_spi_read_regs(tp_spi_reg_t *regs, uint8_t count);
+void tp_spi_write_regs(const tp_spi_reg_t *regs, uint8_t count);
+void tp_spi_acquire_bus(void);
+void tp_spi_release_bus(void);
+void tp_spi_get_stats(tp_spi_stats_t *stats_out, bool reset);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TP_SPI_H*/
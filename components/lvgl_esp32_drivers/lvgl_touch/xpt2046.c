@@ -1,178 +1,425 @@
-/**
- * @file XPT2046.c
- *
- */
-
-/*********************
- *      INCLUDES
- *********************/
-#include "xpt2046.h"
-#include "esp_system.h"
-#include "esp_log.h"
-#include "driver/gpio.h"
-#include "tp_spi.h"
-#include <stddef.h>
-
-/*********************
- *      DEFINES
- *********************/
-#define TAG "XPT2046"
-
-#define CMD_X_READ  0b10010000
-#define CMD_Y_READ  0b11010000
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-/**********************
- *  STATIC PROTOTYPES
- **********************/
-static void xpt2046_corr(int16_t * x, int16_t * y);
-static void xpt2046_avg(int16_t * x, int16_t * y);
-
-/**********************
- *  STATIC VARIABLES
- **********************/
-int16_t avg_buf_x[XPT2046_AVG];
-int16_t avg_buf_y[XPT2046_AVG];
-uint8_t avg_last;
-
-/**********************
- *      MACROS
- **********************/
-
-/**********************
- *   GLOBAL FUNCTIONS
- **********************/
-
-/**
- * Initialize the XPT2046
- */
-void xpt2046_init(void)
-{
-    gpio_config_t irq_config = {
-        .pin_bit_mask = BIT64(XPT2046_IRQ),
-        .mode = GPIO_MODE_INPUT,
-        .pull_up_en = GPIO_PULLUP_DISABLE,
-        .pull_down_en = GPIO_PULLDOWN_DISABLE,
-        .intr_type = GPIO_INTR_DISABLE,
-    };
-    
-    ESP_LOGI(TAG, "XPT2046 Initialization");
-
-    esp_err_t ret = gpio_config(&irq_config);
-    assert(ret == ESP_OK);
-}
-
-/**
- * Get the current position and state of the touchpad
- * @param data store the read data here
- * @return false: because no more data to be read
- */
-bool xpt2046_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
-{
-    static int16_t last_x = 0;
-    static int16_t last_y = 0;
-    bool valid = true;
-
-    int16_t x = 0;
-    int16_t y = 0;
-
-    uint8_t irq = gpio_get_level(XPT2046_IRQ);
-
-    if (irq == 0) {
-		uint8_t data[2];
-		
-		tp_spi_read_reg(CMD_X_READ, data, 2);
-		x = (data[0] << 8) | data[1];
-		
-		tp_spi_read_reg(CMD_Y_READ, data, 2);
-		y = (data[0] << 8) | data[1];
-		
-        /*Normalize Data back to 12-bits*/
-        x = x >> 4;
-        y = y >> 4;
-		
-        xpt2046_corr(&x, &y);
-        xpt2046_avg(&x, &y);
-        last_x = x;
-        last_y = y;
-
-		//ESP_LOGI(TAG, "x = %d, y = %d", x, y);
-    } else {
-        x = last_x;
-        y = last_y;
-        avg_last = 0;
-        valid = false;
-    }
-
-    data->point.x = x;
-    data->point.y = y;
-    data->state = valid == false ? LV_INDEV_STATE_REL : LV_INDEV_STATE_PR;
-
-    return false;
-}
-
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-static void xpt2046_corr(int16_t * x, int16_t * y)
-{
-#if XPT2046_XY_SWAP != 0
-    int16_t swap_tmp;
-    swap_tmp = *x;
-    *x = *y;
-    *y = swap_tmp;
-#endif
-
-    if((*x) > XPT2046_X_MIN)(*x) -= XPT2046_X_MIN;
-    else(*x) = 0;
-
-    if((*y) > XPT2046_Y_MIN)(*y) -= XPT2046_Y_MIN;
-    else(*y) = 0;
-
-    (*x) = (uint32_t)((uint32_t)(*x) * LV_HOR_RES) /
-           (XPT2046_X_MAX - XPT2046_X_MIN);
-
-    (*y) = (uint32_t)((uint32_t)(*y) * LV_VER_RES) /
-           (XPT2046_Y_MAX - XPT2046_Y_MIN);
-
-#if XPT2046_X_INV != 0
-    (*x) =  LV_HOR_RES - (*x);
-#endif
-
-#if XPT2046_Y_INV != 0
-    (*y) =  LV_VER_RES - (*y);
-#endif
-
-
-}
-
-
-static void xpt2046_avg(int16_t * x, int16_t * y)
-{
-    /*Shift out the oldest data*/
-    uint8_t i;
-    for(i = XPT2046_AVG - 1; i > 0 ; i--) {
-        avg_buf_x[i] = avg_buf_x[i - 1];
-        avg_buf_y[i] = avg_buf_y[i - 1];
-    }
-
-    /*Insert the new point*/
-    avg_buf_x[0] = *x;
-    avg_buf_y[0] = *y;
-    if(avg_last < XPT2046_AVG) avg_last++;
-
-    /*Sum the x and y coordinates*/
-    int32_t x_sum = 0;
-    int32_t y_sum = 0;
-    for(i = 0; i < avg_last ; i++) {
-        x_sum += avg_buf_x[i];
-        y_sum += avg_buf_y[i];
-    }
-
-    /*Normalize the sums*/
-    (*x) = (int32_t)x_sum / avg_last;
-    (*y) = (int32_t)y_sum / avg_last;
-}
+/**
+ * @file XPT2046.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "xpt2046.h"
+#include "esp_system.h"
+#include "esp_attr.h"
+#include "esp_log.h"
+#include "driver/gpio.h"
+#include "tp_spi.h"
+#include "touch_driver.h"
+#include "touch_filter.h"
+#include "touch_calib.h"
+#include <stddef.h>
+#include <string.h>
+#include "esp_timer.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "XPT2046"
+
+#define CMD_X_READ  0b10010000
+#define CMD_Y_READ  0b11010000
+#define CMD_Z1_READ 0b10110000
+#define CMD_Z2_READ 0b11000000
+#define CMD_TEMP0_READ 0b10000111   /*Single ended, internal reference and ADC kept on*/
+
+/*Plausible TEMP0 results, a missing chip reads all zeros or all ones*/
+#define PROBE_MIN   0x080
+#define PROBE_MAX   0xF80
+
+/* Each conversion takes its command byte plus 16 clocks, the next command
+ * overlapping the last byte of the previous result. One trailing byte clocks
+ * out the final result. Rounded up to whole words so the SPI master can DMA
+ * straight into the buffer. */
+#define CHANNELS    4
+#define FRAME_LEN   ((2 * CHANNELS * XPT2046_OVERSAMPLE + 1 + 3) & ~3)
+
+#if XPT2046_IRQ_MODE
+#define SAMPLE_PERIOD_US    (1000000 / XPT2046_SAMPLE_RATE)
+#define TASK_STACK_SIZE     2560
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+#if XPT2046_IRQ_MODE
+typedef struct {
+    int16_t x;
+    int16_t y;
+    int64_t time;       /*esp_timer time of the sample [us]*/
+    bool pressed;
+} xpt2046_point_t;
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void xpt2046_corr(int16_t * x, int16_t * y);
+static bool xpt2046_sample(int16_t * x, int16_t * y);
+static int16_t median(int16_t * v, uint8_t n);
+#if XPT2046_IRQ_MODE
+static void IRAM_ATTR xpt2046_irq_handler(void * arg);
+static void xpt2046_timer_cb(void * arg);
+static void xpt2046_task(void * arg);
+static void xpt2046_arm_irq(void);
+static void ring_push(const xpt2046_point_t * p);
+static bool ring_pop(xpt2046_point_t * p, bool * more);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static WORD_ALIGNED_ATTR uint8_t frame_tx[FRAME_LEN];
+static WORD_ALIGNED_ATTR uint8_t frame_rx[FRAME_LEN];
+static touch_filter_t filter;
+static int64_t read_time;      /*Acquisition of the point last returned by xpt2046_read()*/
+
+#if XPT2046_IRQ_MODE
+static TaskHandle_t sample_task;
+static esp_timer_handle_t sample_timer;
+static xpt2046_point_t ring[XPT2046_BUF_POINTS];
+static uint16_t ring_head;     /*Next point to write*/
+static uint16_t ring_tail;     /*Next point to read*/
+static portMUX_TYPE ring_mux = portMUX_INITIALIZER_UNLOCKED;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Check for an XPT2046 on the touch SPI device. It has no ID register, so
+ * the temperature diode is converted and a result away from the rails is
+ * taken as its presence.
+ * @return true if the conversion looks plausible
+ */
+bool xpt2046_probe(void)
+{
+    /*Second conversion after the reference settled, then an X read
+     *(power down between conversions) to re-enable PENIRQ*/
+    WORD_ALIGNED_ATTR uint8_t tx[12] = {CMD_TEMP0_READ, 0, 0, CMD_TEMP0_READ, 0, 0, CMD_X_READ, 0, 0};
+    WORD_ALIGNED_ATTR uint8_t rx[12];
+
+    tp_spi_xchg(tx, rx, 9);
+    uint16_t temp = ((rx[4] << 8) | rx[5]) >> 3;
+
+    ESP_LOGI(TAG, "Probe: TEMP0 0x%03x", temp);
+    return temp >= PROBE_MIN && temp <= PROBE_MAX;
+}
+
+/**
+ * Initialize the XPT2046
+ */
+void xpt2046_init(void)
+{
+    gpio_config_t irq_config = {
+        .pin_bit_mask = BIT64(XPT2046_IRQ),
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+#if XPT2046_IRQ_MODE
+        .intr_type = GPIO_INTR_NEGEDGE,     /*PENIRQ goes low on pen down*/
+#else
+        .intr_type = GPIO_INTR_DISABLE,
+#endif
+    };
+    
+    ESP_LOGI(TAG, "XPT2046 Initialization");
+
+    esp_err_t ret = gpio_config(&irq_config);
+    assert(ret == ESP_OK);
+
+    /*X, Y, Z1, Z2 repeated, the rest of the frame stays zero*/
+    static const uint8_t cmds[CHANNELS] = {CMD_X_READ, CMD_Y_READ, CMD_Z1_READ, CMD_Z2_READ};
+    memset(frame_tx, 0, sizeof(frame_tx));
+    for(uint8_t i = 0; i < CHANNELS * XPT2046_OVERSAMPLE; i++) {
+        frame_tx[2 * i] = cmds[i % CHANNELS];
+    }
+
+    static const touch_filter_cfg_t filter_cfg = TOUCH_FILTER_CFG(XPT2046);
+    touch_filter_init(&filter, &filter_cfg);
+
+#if XPT2046_IRQ_MODE
+    const esp_timer_create_args_t timer_args = {
+        .callback = xpt2046_timer_cb,
+        .name = "xpt2046"
+    };
+    ret = esp_timer_create(&timer_args, &sample_timer);
+    assert(ret == ESP_OK);
+
+    BaseType_t core = touch_driver_get_task_core();
+    ret = xTaskCreatePinnedToCore(xpt2046_task, "xpt2046", TASK_STACK_SIZE, NULL,
+            touch_driver_get_task_priority(), &sample_task, core);
+    assert(ret == pdPASS);
+
+    /*The service may already be installed by someone else*/
+    ret = gpio_install_isr_service(0);
+    assert(ret == ESP_OK || ret == ESP_ERR_INVALID_STATE);
+    gpio_intr_disable(XPT2046_IRQ);
+    ret = gpio_isr_handler_add(XPT2046_IRQ, xpt2046_irq_handler, NULL);
+    assert(ret == ESP_OK);
+
+    xpt2046_arm_irq();
+
+    ESP_LOGI(TAG, "Interrupt driven sampling at %d Hz", XPT2046_SAMPLE_RATE);
+#endif
+}
+
+/**
+ * Get the current position and state of the touchpad
+ * @param data store the read data here
+ * @return true: if buffered points are left (interrupt driven mode)
+ */
+bool xpt2046_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
+{
+#if XPT2046_IRQ_MODE
+    static xpt2046_point_t last;
+    xpt2046_point_t p;
+    bool more = false;
+
+    /*Without new points the last state holds*/
+    if(ring_pop(&p, &more)) last = p;
+
+    read_time = last.time;
+    data->point.x = last.x;
+    data->point.y = last.y;
+    data->state = last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+
+    return more;
+#else
+    bool valid = false;
+
+    int16_t x = 0;
+    int16_t y = 0;
+
+    uint8_t irq = gpio_get_level(XPT2046_IRQ);
+
+    if (irq == 0 && xpt2046_sample(&x, &y)) {
+        valid = true;
+		//ESP_LOGI(TAG, "x = %d, y = %d", x, y);
+    }
+
+    /*Gives the last position when released*/
+    valid = touch_filter_apply(&filter, valid, &x, &y);
+
+    read_time = esp_timer_get_time();
+    data->point.x = x;
+    data->point.y = y;
+    data->state = valid == false ? LV_INDEV_STATE_REL : LV_INDEV_STATE_PR;
+
+    return false;
+#endif
+}
+
+/**
+ * @return the sampling task, NULL if the controller is polled by LVGL
+ */
+TaskHandle_t xpt2046_get_task(void)
+{
+#if XPT2046_IRQ_MODE
+    return sample_task;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * Get the time a point was acquired at. Buffered points of the interrupt
+ * driven mode are older than the read that returns them.
+ * @return esp_timer time of the point last returned by xpt2046_read() [us]
+ */
+int64_t xpt2046_get_time(void)
+{
+    return read_time;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Read one point in a single transaction
+ * @return false if the pressure is too low for a reliable position */
+static bool xpt2046_sample(int16_t * x, int16_t * y)
+{
+    int16_t ch[CHANNELS][XPT2046_OVERSAMPLE];
+
+    tp_spi_xchg(frame_tx, frame_rx, FRAME_LEN);
+
+    for(uint8_t i = 0; i < CHANNELS * XPT2046_OVERSAMPLE; i++) {
+        /*Busy bit, 12 data bits, 3 zero bits*/
+        ch[i % CHANNELS][i / CHANNELS] = ((frame_rx[2 * i + 1] << 8) | frame_rx[2 * i + 2]) >> 3;
+    }
+
+    /*11 bit positions as read before, the X/Y_MIN/MAX settings are in that range*/
+    *x = median(ch[0], XPT2046_OVERSAMPLE) >> 1;
+    *y = median(ch[1], XPT2046_OVERSAMPLE) >> 1;
+    int16_t z1 = median(ch[2], XPT2046_OVERSAMPLE);
+    int16_t z2 = median(ch[3], XPT2046_OVERSAMPLE);
+
+#if XPT2046_Z_THRESHOLD
+    if(z1 == 0 || z1 + 4095 - z2 < XPT2046_Z_THRESHOLD) return false;
+#else
+    (void)z1;
+    (void)z2;
+#endif
+
+    xpt2046_corr(x, y);
+    return true;
+}
+
+/* Sorts v in place */
+static int16_t median(int16_t * v, uint8_t n)
+{
+    for(uint8_t i = 1; i < n; i++) {
+        int16_t t = v[i];
+        uint8_t j = i;
+        for(; j > 0 && v[j - 1] > t; j--) v[j] = v[j - 1];
+        v[j] = t;
+    }
+
+    if(n & 1) return v[n / 2];
+    return (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+#if XPT2046_IRQ_MODE
+static void IRAM_ATTR xpt2046_irq_handler(void * arg)
+{
+    BaseType_t woken = pdFALSE;
+
+    /*Stays off while sampling, conversions can glitch PENIRQ*/
+    gpio_intr_disable(XPT2046_IRQ);
+    vTaskNotifyGiveFromISR(sample_task, &woken);
+    if(woken) portYIELD_FROM_ISR();
+}
+
+static void xpt2046_timer_cb(void * arg)
+{
+    xTaskNotifyGive(sample_task);
+}
+
+/* Woken by pen down, samples on every timer tick until the pen is lifted */
+static void xpt2046_task(void * arg)
+{
+    xpt2046_point_t p = {0};
+
+    for(;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        /*A timer tick left over from the last touch*/
+        if(gpio_get_level(XPT2046_IRQ) != 0) {
+            xpt2046_arm_irq();
+            continue;
+        }
+
+        esp_timer_start_periodic(sample_timer, SAMPLE_PERIOD_US);
+
+        /*Until the pen is up and the filter stopped holding the press*/
+        bool down = false;
+        for(;;) {
+            bool pen = gpio_get_level(XPT2046_IRQ) == 0;
+            /*Samples taken while the pen is still landing fail the pressure check*/
+            bool pressed = pen && xpt2046_sample(&p.x, &p.y);
+            bool was_down = down;
+            down = touch_filter_apply(&filter, pressed, &p.x, &p.y);
+
+            /*New points and the release, at the last position*/
+            if(pressed || (was_down && !down)) {
+                p.time = esp_timer_get_time();
+                p.pressed = down;
+                ring_push(&p);
+            }
+
+            if(!pen && !down) break;
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        }
+
+        esp_timer_stop(sample_timer);
+        xpt2046_arm_irq();
+    }
+}
+
+/* Enable the pen-down interrupt without losing a touch that is already there */
+static void xpt2046_arm_irq(void)
+{
+    gpio_intr_enable(XPT2046_IRQ);
+
+    if(gpio_get_level(XPT2046_IRQ) == 0) {
+        gpio_intr_disable(XPT2046_IRQ);
+        xTaskNotifyGive(sample_task);
+    }
+}
+
+/* Add a point, dropping the oldest one if LVGL fell behind */
+static void ring_push(const xpt2046_point_t * p)
+{
+    portENTER_CRITICAL(&ring_mux);
+    ring[ring_head] = *p;
+    ring_head = (ring_head + 1) % XPT2046_BUF_POINTS;
+    if(ring_head == ring_tail) ring_tail = (ring_tail + 1) % XPT2046_BUF_POINTS;
+    portEXIT_CRITICAL(&ring_mux);
+}
+
+static bool ring_pop(xpt2046_point_t * p, bool * more)
+{
+    bool ok = false;
+
+    portENTER_CRITICAL(&ring_mux);
+    if(ring_tail != ring_head) {
+        *p = ring[ring_tail];
+        ring_tail = (ring_tail + 1) % XPT2046_BUF_POINTS;
+        ok = true;
+    }
+    *more = ring_tail != ring_head;
+    portEXIT_CRITICAL(&ring_mux);
+
+    return ok;
+}
+#endif
+static void xpt2046_corr(int16_t * x, int16_t * y)
+{
+#if TOUCH_CALIB_ENABLED
+    /*The stored matrix covers swap, inversion and scaling*/
+    if(touch_calib_map(x, y)) return;
+#endif
+
+#if XPT2046_XY_SWAP != 0
+    int16_t swap_tmp;
+    swap_tmp = *x;
+    *x = *y;
+    *y = swap_tmp;
+#endif
+
+    if((*x) > XPT2046_X_MIN)(*x) -= XPT2046_X_MIN;
+    else(*x) = 0;
+
+    if((*y) > XPT2046_Y_MIN)(*y) -= XPT2046_Y_MIN;
+    else(*y) = 0;
+
+    (*x) = (uint32_t)((uint32_t)(*x) * LV_HOR_RES) /
+           (XPT2046_X_MAX - XPT2046_X_MIN);
+
+    (*y) = (uint32_t)((uint32_t)(*y) * LV_VER_RES) /
+           (XPT2046_Y_MAX - XPT2046_Y_MIN);
+
+#if XPT2046_X_INV != 0
+    (*x) =  LV_HOR_RES - (*x);
+#endif
+
+#if XPT2046_Y_INV != 0
+    (*y) =  LV_VER_RES - (*y);
+#endif
+
+
+}
+
@@ -1,52 +1,74 @@
-/**
- * @file XPT2046.h
- *
- */
-
-#ifndef XPT2046_H
-#define XPT2046_H
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-/*********************
- *      INCLUDES
- *********************/
-
-#include <stdint.h>
-#include <stdbool.h>
-#include "lvgl/lvgl.h"
-
-/*********************
- *      DEFINES
- *********************/
-#define XPT2046_IRQ CONFIG_LVGL_TOUCH_PIN_IRQ
-
-#define XPT2046_AVG 4
-#define XPT2046_X_MIN       CONFIG_LVGL_TOUCH_X_MIN
-#define XPT2046_Y_MIN       CONFIG_LVGL_TOUCH_Y_MIN
-#define XPT2046_X_MAX       CONFIG_LVGL_TOUCH_X_MAX
-#define XPT2046_Y_MAX       CONFIG_LVGL_TOUCH_Y_MAX
-#define XPT2046_X_INV       CONFIG_LVGL_TOUCH_INVERT_X
-#define XPT2046_Y_INV       CONFIG_LVGL_TOUCH_INVERT_Y
-
-/**********************
- *      TYPEDEFS
- **********************/
-
-/**********************
- * GLOBAL PROTOTYPES
- **********************/
-void xpt2046_init(void);
-bool xpt2046_read(lv_indev_drv_t * drv, lv_indev_data_t * data);
-
-/**********************
- *      MACROS
- **********************/
-
-#ifdef __cplusplus
-} /* extern "C" */
-#endif
-
-#endif /* XPT2046_H */
+/**
+ * @file XPT2046.h
+ *
+ */
+
+#ifndef XPT2046_H
+#define XPT2046_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define XPT2046_IRQ CONFIG_LVGL_TOUCH_PIN_IRQ
+
+#if CONFIG_LVGL_TOUCH_CONTROLLER_AUTO
+#define XPT2046_X_MIN       CONFIG_LVGL_TOUCH_XPT2046_X_MIN
+#define XPT2046_Y_MIN       CONFIG_LVGL_TOUCH_XPT2046_Y_MIN
+#define XPT2046_X_MAX       CONFIG_LVGL_TOUCH_XPT2046_X_MAX
+#define XPT2046_Y_MAX       CONFIG_LVGL_TOUCH_XPT2046_Y_MAX
+#define XPT2046_X_INV       CONFIG_LVGL_TOUCH_XPT2046_INVERT_X
+#define XPT2046_Y_INV       CONFIG_LVGL_TOUCH_XPT2046_INVERT_Y
+#else
+#define XPT2046_X_MIN       CONFIG_LVGL_TOUCH_X_MIN
+#define XPT2046_Y_MIN       CONFIG_LVGL_TOUCH_Y_MIN
+#define XPT2046_X_MAX       CONFIG_LVGL_TOUCH_X_MAX
+#define XPT2046_Y_MAX       CONFIG_LVGL_TOUCH_Y_MAX
+#define XPT2046_X_INV       CONFIG_LVGL_TOUCH_INVERT_X
+#define XPT2046_Y_INV       CONFIG_LVGL_TOUCH_INVERT_Y
+#endif
+
+#define XPT2046_OVERSAMPLE  CONFIG_LVGL_TOUCH_XPT2046_OVERSAMPLE
+#define XPT2046_Z_THRESHOLD CONFIG_LVGL_TOUCH_XPT2046_Z_THRESHOLD
+
+#define XPT2046_IRQ_MODE    CONFIG_LVGL_TOUCH_XPT2046_IRQ_MODE
+#if XPT2046_IRQ_MODE
+#define XPT2046_SAMPLE_RATE CONFIG_LVGL_TOUCH_XPT2046_SAMPLE_RATE
+#define XPT2046_BUF_POINTS  CONFIG_LVGL_TOUCH_XPT2046_BUF_POINTS
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool xpt2046_probe(void);
+void xpt2046_init(void);
+bool xpt2046_read(lv_indev_drv_t * drv, lv_indev_data_t * data);
+TaskHandle_t xpt2046_get_task(void);
+int64_t xpt2046_get_time(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* XPT2046_H */
@@ -1,2 +1,2 @@
-# websocket component makefile
+# websocket component makefile
 # all files are in default positions
\ No newline at end of file
@@ -0,0 +1,63 @@
+// broadcast cost against client count: ws_send() for every client, as the server did
+// before, against a frame encoded once with ws_frame_encode() and sent to every client
+// with ws_send_frame(), as send_frame_clients() in websocket_server.c does
+
+#include <stdio.h>
+#include <string.h>
+#include "websocket.h"
+#include "host_stubs.h"
+
+#define MAX_CLIENTS 1000
+#define SENDS 4000000 // per measurement, spread over the clients
+
+static ws_client_t clients[MAX_CLIENTS];
+static struct netconn conns[MAX_CLIENTS];
+
+static void per_client(int n,char* msg,uint64_t len) {
+  for(int i=0;i<n;i++) ws_send(&clients[i],WEBSOCKET_OPCODE_TEXT,msg,len,0);
+}
+
+static void encode_once(int n,char* msg,uint64_t len) {
+  ws_frame_t frame;
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_TEXT,msg,len);
+  for(int i=0;i<n;i++) ws_send_frame(&clients[i],&frame);
+}
+
+// ns per client and broadcast
+static double bench(void (*broadcast)(int,char*,uint64_t),int n,char* msg,uint64_t len) {
+  int rounds = SENDS / n;
+  double t = host_now_ns();
+  for(int r=0;r<rounds;r++) broadcast(n,msg,len);
+  return (host_now_ns() - t) / rounds / n;
+}
+
+int main(void) {
+  static char msg[1024];
+  uint64_t lens[] = {16,200,1024};
+  int counts[] = {1,5,20,100,1000};
+
+  memset(msg,'a',sizeof(msg));
+  for(int i=0;i<MAX_CLIENTS;i++) clients[i] = ws_connect_client(&conns[i],"/",NULL,NULL);
+
+  // both must put the same bytes on the wire
+  host_bytes_written = 0;
+  per_client(MAX_CLIENTS,msg,200);
+  uint64_t expected = host_bytes_written;
+  host_bytes_written = 0;
+  encode_once(MAX_CLIENTS,msg,200);
+  if(host_bytes_written != expected || expected != MAX_CLIENTS * (200 + 4)) {
+    printf("FAIL %llu bytes written, expected %llu\n",
+           (unsigned long long)host_bytes_written,(unsigned long long)expected);
+    return 1;
+  }
+
+  printf("ns per client and broadcast, the network stub copies the payload\n");
+  printf("payload  clients  ws_send per client  encode once\n");
+  for(size_t l=0;l<sizeof(lens)/sizeof(lens[0]);l++) {
+    for(size_t c=0;c<sizeof(counts)/sizeof(counts[0]);c++) {
+      printf("%7llu  %7d  %18.1f  %11.1f\n",(unsigned long long)lens[l],counts[c],
+             bench(per_client,counts[c],msg,lens[l]),bench(encode_once,counts[c],msg,lens[l]));
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,57 @@
+// lwIP, mbedTLS and esp_system functions websocket.c links against on the host.
+// writes copy the data into a sink, as lwIP copies NETCONN_COPY data into the send buffer
+
+#include <string.h>
+#include "lwip/api.h"
+#include "host_stubs.h"
+
+static uint8_t sink[4096];
+uint64_t host_bytes_written;
+
+err_t netconn_write_partly(struct netconn* conn,const void* dataptr,size_t size,u8_t apiflags,size_t* bytes_written) {
+  memcpy(sink,dataptr,size < sizeof(sink) ? size : sizeof(sink));
+  host_bytes_written += size;
+  if(bytes_written) *bytes_written = size;
+  return ERR_OK;
+}
+
+err_t netconn_write_vectors_partly(struct netconn* conn,struct netvector* vectors,u16_t vectorcnt,u8_t apiflags,size_t* bytes_written) {
+  size_t total = 0;
+  for(u16_t i=0;i<vectorcnt;i++) {
+    netconn_write_partly(conn,vectors[i].ptr,vectors[i].len,apiflags,NULL);
+    total += vectors[i].len;
+  }
+  if(bytes_written) *bytes_written = total;
+  return ERR_OK;
+}
+
+err_t netconn_recv(struct netconn* conn,struct netbuf** new_buf) { return ERR_CONN; }
+err_t netconn_close(struct netconn* conn) { return ERR_OK; }
+err_t netconn_delete(struct netconn* conn) { return ERR_OK; }
+err_t netbuf_data(struct netbuf* buf,void** dataptr,u16_t* len) { return ERR_CONN; }
+s8_t netbuf_next(struct netbuf* buf) { return -1; }
+void netbuf_delete(struct netbuf* buf) {}
+
+uint32_t esp_random(void) {
+  return (uint32_t)rand() << 16 ^ (uint32_t)rand();
+}
+
+int mbedtls_base64_encode(unsigned char* dst,size_t dlen,size_t* olen,const unsigned char* src,size_t slen) { return -1; }
+int mbedtls_sha1(const unsigned char* input,size_t ilen,unsigned char output[20]) { return -1; }
+
+// glibc before 2.38 has no strlcpy
+__attribute__((weak)) size_t strlcpy(char* dst,const char* src,size_t size) {
+  size_t len = strlen(src);
+  if(size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst,src,n);
+    dst[n] = 0;
+  }
+  return len;
+}
+
+double host_now_ns(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec * 1e9 + t.tv_nsec;
+}
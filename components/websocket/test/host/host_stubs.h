@@ -0,0 +1,11 @@
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <stdint.h>
+#include <time.h>
+
+extern uint64_t host_bytes_written; // by all netconn writes
+
+double host_now_ns(void); // monotonic clock
+
+#endif
@@ -0,0 +1,3 @@
+// newlib declares strlcpy() in string.h, glibc only since 2.38. host_stubs.c defines it
+#include <stddef.h>
+size_t strlcpy(char* dst,const char* src,size_t size);
@@ -0,0 +1,53 @@
+// host stand-in for the parts of the lwIP netconn API websocket.c uses
+#ifndef HOST_LWIP_API_H
+#define HOST_LWIP_API_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "sdkconfig.h"
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef int8_t s8_t;
+typedef int8_t err_t;
+
+#define ERR_OK 0
+#define ERR_CONN -11
+
+#define NETCONN_NOCOPY 0x00
+#define NETCONN_COPY 0x01
+#define NETCONN_MORE 0x02
+
+enum netconn_evt {
+  NETCONN_EVT_RCVPLUS,
+  NETCONN_EVT_RCVMINUS,
+  NETCONN_EVT_SENDPLUS,
+  NETCONN_EVT_SENDMINUS,
+  NETCONN_EVT_ERROR
+};
+
+struct netconn;
+typedef void (*netconn_callback)(struct netconn*,enum netconn_evt,u16_t len);
+struct netconn {
+  netconn_callback callback;
+};
+
+struct netbuf;
+struct netvector {
+  const void* ptr;
+  size_t len;
+};
+
+err_t netconn_write_partly(struct netconn* conn,const void* dataptr,size_t size,u8_t apiflags,size_t* bytes_written);
+err_t netconn_write_vectors_partly(struct netconn* conn,struct netvector* vectors,u16_t vectorcnt,u8_t apiflags,size_t* bytes_written);
+#define netconn_write(conn,dataptr,size,apiflags) netconn_write_partly(conn,dataptr,size,apiflags,NULL)
+err_t netconn_recv(struct netconn* conn,struct netbuf** new_buf);
+err_t netconn_close(struct netconn* conn);
+err_t netconn_delete(struct netconn* conn);
+err_t netbuf_data(struct netbuf* buf,void** dataptr,u16_t* len);
+s8_t netbuf_next(struct netbuf* buf);
+void netbuf_delete(struct netbuf* buf);
+
+#endif
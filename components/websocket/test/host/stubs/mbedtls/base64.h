@@ -0,0 +1,2 @@
+#include <stddef.h>
+int mbedtls_base64_encode(unsigned char* dst,size_t dlen,size_t* olen,const unsigned char* src,size_t slen);
@@ -0,0 +1,2 @@
+#include <stddef.h>
+int mbedtls_sha1(const unsigned char* input,size_t ilen,unsigned char output[20]);
@@ -0,0 +1,4 @@
+// Kconfig defaults of the websocket component
+#define CONFIG_WEBSOCKET_SERVER_MAX_CLIENTS 20
+#define CONFIG_WEBSOCKET_MAX_MESSAGE_SIZE 32768
+#define CONFIG_WEBSOCKET_MAX_TOTAL_SIZE 65536
@@ -0,0 +1,66 @@
+// checks ws_mask() against the plain byte loop over random alignments, lengths, keys
+// and stream offsets, then compares their throughput
+
+#include <stdio.h>
+#include <string.h>
+#include "websocket.h"
+#include "host_stubs.h"
+
+#define BUF_SIZE 4096
+#define ROUNDS 200000
+#define BENCH_BYTES (256ull << 20)
+
+// the RFC 6455 definition: byte i is xored with key byte (offset + i) % 4
+static void ref_mask(char* msg,uint64_t len,uint32_t key,uint64_t offset) {
+  const uint8_t* part = (const uint8_t*)&key;
+  for(uint64_t i=0;i<len;i++) msg[i] ^= part[(offset + i) % 4];
+}
+
+static int check(const char* src,size_t align,size_t len,uint32_t key,uint64_t offset) {
+  static char a[BUF_SIZE + 64],b[BUF_SIZE + 64];
+
+  memcpy(a,src,sizeof(a));
+  memcpy(b,src,sizeof(b));
+  ws_mask(&a[align],len,key,offset);
+  ref_mask(&b[align],len,key,offset);
+  if(!memcmp(a,b,sizeof(a))) return 1; // also catches writes outside of [align,align+len)
+  printf("FAIL align %zu len %zu key %08x offset %llu\n",align,len,key,(unsigned long long)offset);
+  return 0;
+}
+
+static double bench(void (*mask)(char*,uint64_t,uint32_t,uint64_t),char* buf,size_t len) {
+  double t = host_now_ns();
+  for(uint64_t done=0;done<BENCH_BYTES;done+=len) mask(buf,len,0x12345678,done);
+  return BENCH_BYTES / ((host_now_ns() - t) / 1e9) / 1e6;
+}
+
+int main(void) {
+  static char src[BUF_SIZE + 64];
+  int ok = 1;
+
+  srand(1);
+  for(size_t i=0;i<sizeof(src);i++) src[i] = rand();
+
+  // every alignment, short lengths and offset combination exhaustively
+  for(size_t align=0;align<16;align++)
+    for(size_t len=0;len<80;len++)
+      for(uint64_t offset=0;offset<8;offset++)
+        ok &= check(src,align,len,0xA1B2C3D4,offset);
+
+  for(int r=0;r<ROUNDS && ok;r++) {
+    size_t align = rand() % 64;
+    size_t len = rand() % 8 ? rand() % 300 : rand() % BUF_SIZE;
+    uint32_t key = (uint32_t)rand() << 16 ^ rand();
+    uint64_t offset = rand() % 2 ? rand() % 16 : (uint64_t)rand() << 32 | rand();
+    ok &= check(src,align,len,key,offset);
+  }
+  if(!ok) return 1;
+  printf("ws_mask matches the byte loop (%d random cases)\n",ROUNDS);
+
+  size_t sizes[] = {16,125,1024,4096};
+  for(size_t i=0;i<sizeof(sizes)/sizeof(sizes[0]);i++) {
+    printf("%5zu byte payloads: byte loop %7.0f MB/s, ws_mask %7.0f MB/s\n",sizes[i],
+           bench(ref_mask,src,sizes[i]),bench(ws_mask,src,sizes[i]));
+  }
+  return 0;
+}
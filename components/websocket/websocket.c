@@ -1,321 +1,495 @@
-
-/*
-esp32-websocket - a websocket component on esp-idf
-Copyright (C) 2019 Blake Felt - blake.w.felt@gmail.com
-
-This program is free software: you can redistribute it and/or modify
-    it under the terms of the GNU General Public License as published by
-    the Free Software Foundation, either version 3 of the License, or
-    (at your option) any later version.
-
-    This program is distributed in the hope that it will be useful,
-    but WITHOUT ANY WARRANTY; without even the implied warranty of
-    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-    GNU General Public License for more details.
-
-    You should have received a copy of the GNU General Public License
-    along with this program.  If not, see <https://www.gnu.org/licenses/>.
-*/
-
-#include "websocket.h"
-#include "lwip/tcp.h" // for the netconn structure
-#include "esp_system.h" // for esp_random
-#include "mbedtls/base64.h"
-#include "mbedtls/sha1.h"
-#include <string.h>
-
-ws_client_t ws_connect_client(struct netconn* conn,
-                              char* url,
-                              void (*ccallback)(WEBSOCKET_TYPE_t type,char* msg,uint64_t len),
-                              void (*scallback)(uint8_t num,WEBSOCKET_TYPE_t type,char* msg,uint64_t len)
-                            ) {
-  ws_client_t client;
-  client.conn = conn;
-  client.url  = url;
-  client.ping = 0;
-  client.last_opcode = 0;
-  client.contin = NULL;
-  client.len = 0;
-  client.unfinished = 0;
-  client.ccallback = ccallback;
-  client.scallback = scallback;
-  return client;
-}
-
-void ws_disconnect_client(ws_client_t* client,bool mask) {
-  ws_send(client,WEBSOCKET_OPCODE_CLOSE,NULL,0,mask); // tell the client to close
-  if(client->conn) {
-    client->conn->callback = NULL; // shut off the callback
-    netconn_close(client->conn);
-    netconn_delete(client->conn);
-    client->conn = NULL;
-  }
-  client->url = NULL;
-  client->last_opcode = 0;
-  if(client->len) {
-    if(client->contin)
-      free(client->contin);
-    client->len = 0;
-  }
-  client->ccallback = NULL;
-  client->scallback = NULL;
-}
-
-bool ws_is_connected(ws_client_t client) {
-  if(client.conn)
-    return 1;
-  return 0;
-}
-
-static void ws_generate_mask(ws_header_t* header) {
-  header->param.bit.MASK = 1;
-  header->key.full = esp_random(); // generate a random 32 bit number
-}
-
-static void ws_encrypt_decrypt(char* msg,ws_header_t header) {
-  if(header.param.bit.MASK) {
-    for(uint64_t i=0; i<header.length; i++) {
-      msg[i] ^= header.key.part[i%4];
-    }
-  }
-}
-
-int ws_send(ws_client_t* client,WEBSOCKET_OPCODES_t opcode,char* msg,uint64_t len,bool mask) {
-  char* out;
-  char* encrypt;
-  uint64_t pos;
-  uint64_t true_len;
-  ws_header_t header;
-  int ret;
-
-  header.param.pos.ZERO = 0; // reset the whole header
-  header.param.pos.ONE  = 0;
-
-  header.param.bit.FIN = 1; // all pieces are done (you don't need a huge message anyway...)
-  header.param.bit.OPCODE = opcode;
-  // populate LEN field
-  pos = 2;
-  header.length = len;
-  if(len<=125) {
-    header.param.bit.LEN = len;
-  }
-  else if(len<65536) {
-    header.param.bit.LEN = 126;
-    pos += 2;
-  }
-  else {
-    header.param.bit.LEN = 127;
-    pos += 8;
-  }
-
-  if(mask) {
-    ws_generate_mask(&header); // get a key
-    encrypt = malloc(len); // allocate memory for the encryption
-    memcpy(encrypt,msg,len);
-    ws_encrypt_decrypt(encrypt,header); // encrypt it!
-    pos += 4; // add the position
-  }
-
-  true_len = pos+len; // get the length of the entire message
-  pos = 2;
-  out = malloc(true_len); // allocate dat memory
-
-  out[0] = header.param.pos.ZERO; // save header
-  out[1] = header.param.pos.ONE;
-
-  // put in the length, if necessary
-  if(header.param.bit.LEN == 126) {
-    out[2] = (len >> 8) & 0xFF;
-    out[3] = (len     ) & 0xFF;
-    pos = 4;
-  }
-  if(header.param.bit.LEN == 127) {
-    //memcpy(&out[2],&len,8);
-    out[2] = (len >> 56) & 0xFF;
-    out[3] = (len >> 48) & 0xFF;
-    out[4] = (len >> 40) & 0xFF;
-    out[5] = (len >> 32) & 0xFF;
-    out[6] = (len >> 24) & 0xFF;
-    out[7] = (len >> 16) & 0xFF;
-    out[8] = (len >> 8)  & 0xFF;
-    out[9] = (len)       & 0xFF;
-    pos = 10;
-  }
-
-  if(mask) {
-    out[pos] = header.key.part[0]; pos++;
-    out[pos] = header.key.part[1]; pos++;
-    out[pos] = header.key.part[2]; pos++;
-    out[pos] = header.key.part[3]; pos++;
-    memcpy(&out[pos],encrypt,len); // put in the encrypted message
-    free(encrypt);
-  }
-  else {
-    memcpy(&out[pos],msg,len);
-  }
-
-  ret = netconn_write(client->conn,out,true_len,NETCONN_COPY); // finally! send it.
-  free(out); // free the entire message
-  return ret;
-}
-
-char* ws_read(ws_client_t* client,ws_header_t* header) {
-  char* ret;
-  char* append;
-  err_t err;
-  struct netbuf* inbuf;
-  struct netbuf* inbuf2;
-  char* buf;
-  char* buf2;
-  uint16_t len;
-  uint16_t len2;
-  uint64_t pos;
-  uint64_t cont_len;
-  uint64_t cont_pos;
-
-  // if we read from this previously (not cont frames), stop reading
-  if(client->unfinished) {
-    client->unfinished--;
-    return NULL;
-  }
-
-  err = netconn_recv(client->conn,&inbuf);
-  if(err != ERR_OK) return NULL;
-  netbuf_data(inbuf,(void**)&buf, &len);
-  if(!buf) return NULL;
-
-  // get the header
-  header->param.pos.ZERO = buf[0];
-  header->param.pos.ONE  = buf[1];
-
-  // get the message length
-  pos = 2;
-  if(header->param.bit.LEN <= 125) {
-    header->length = header->param.bit.LEN;
-  }
-  else if(header->param.bit.LEN == 126) {
-    header->length = buf[2] << 8 | buf[3];
-    pos = 4;
-  }
-  else { // LEN = 127
-    header->length = (uint64_t)buf[2] << 56 | (uint64_t)buf[3] << 48
-                   | (uint64_t)buf[4] << 40 | (uint64_t)buf[5] << 32
-                   | (uint64_t)buf[6] << 24 | (uint64_t)buf[7] << 16
-                   | (uint64_t)buf[8] << 8  | (uint64_t)buf[9];
-    pos = 10;
-  }
-
-  if(header->param.bit.MASK) {
-    memcpy(&(header->key.full),&buf[pos],4); // extract the key
-    pos += 4;
-  }
-
-  ret = malloc(header->length+1); // allocate memory, plus a byte
-  if(!ret) {
-    netbuf_delete(inbuf);
-    header->received = 0;
-    return NULL;
-  }
-
-  cont_len = len-pos; // get the actual length
-  memcpy(ret,&buf[pos],header->length); // allocate the total memory
-  cont_pos = cont_len; // get the initial position
-  // netconn gives messages in pieces, so we need to get those (different than OPCODE_CONT)
-  while(cont_len < header->length) { // while the actual length is less than the header stated
-    err = netconn_recv(client->conn,&inbuf2);
-    if(err != ERR_OK) {
-      netbuf_delete(inbuf2);
-      free(ret);
-      client->unfinished = 0;
-      header->received = 0;
-      return NULL;
-    }
-    netbuf_data(inbuf2,(void**)&buf2, &len2);
-    // Prevent catastrophic failure due to memory leakage
-    if(cont_len + len2 > header->length) {
-      netbuf_delete(inbuf2);
-      free(ret);
-      client->unfinished = 0;
-      header->received = 0;
-      return NULL;
-    }
-    memcpy(&ret[cont_pos],buf2,len2);
-    cont_pos += len2;
-    if(!buf2) {
-      client->unfinished = 0;
-      header->received = 0;
-    }
-    netbuf_delete(inbuf2);
-    client->unfinished++;
-    cont_len += len2;
-  }
-
-  ret[header->length] = '\0'; // end string
-  ws_encrypt_decrypt(ret,*header); // unencrypt, if necessary
-
-  if(header->param.bit.FIN == 0) { // if the message isn't done
-    if((header->param.bit.OPCODE == WEBSOCKET_OPCODE_CONT) &&
-       ((client->last_opcode==WEBSOCKET_OPCODE_BIN) || (client->last_opcode==WEBSOCKET_OPCODE_TEXT))) {
-         cont_len = header->length + client->len;
-         append = malloc(cont_len);
-         memcpy(append,client->contin,client->len);
-         memcpy(&append[client->len],ret,header->length);
-         free(client->contin);
-         client->contin = malloc(cont_len);
-         client->len = cont_len;
-
-         free(append);
-         free(ret);
-         netbuf_delete(inbuf);
-         //free(buf);
-         return NULL;
-    }
-    else if((header->param.bit.OPCODE==WEBSOCKET_OPCODE_BIN) || (header->param.bit.OPCODE==WEBSOCKET_OPCODE_TEXT)) {
-      if(client->len) {
-        free(client->contin);
-      }
-      client->contin = malloc(header->length);
-      memcpy(client->contin,ret,header->length);
-      client->len = header->length;
-      client->last_opcode = header->param.bit.OPCODE;
-
-      free(ret);
-      netbuf_delete(inbuf);
-      //free(buf);
-      return NULL;
-    }
-    else { // there shouldn't be another FIN code....
-      free(ret);
-      netbuf_delete(inbuf);
-      //free(buf);
-      return NULL;
-    }
-  }
-  client->last_opcode = header->param.bit.OPCODE;
-  if(inbuf) netbuf_delete(inbuf);
-  header->received = 1;
-  return ret;
-}
-
-char* ws_hash_handshake(char* handshake,uint8_t len) {
-  const char hash[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
-  const uint8_t hash_len = sizeof(hash);
-  char* ret;
-  char key[64];
-  unsigned char sha1sum[20];
-  unsigned int ret_len;
-
-  if(!len) return NULL;
-  ret = malloc(32);
-
-  memcpy(key,handshake,len);
-  strlcpy(&key[len],hash,sizeof(key));
-  mbedtls_sha1((unsigned char*)key,len+hash_len-1,sha1sum);
-  mbedtls_base64_encode(NULL, 0, &ret_len, sha1sum, 20);
-  if(!mbedtls_base64_encode((unsigned char*)ret,32,&ret_len,sha1sum,20)) {
-    ret[ret_len] = '\0';
-    return ret;
-  }
-  free(ret);
-  return NULL;
-}
+
+/*
+esp32-websocket - a websocket component on esp-idf
+Copyright (C) 2019 Blake Felt - blake.w.felt@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "websocket.h"
+#include "lwip/tcp.h" // for the netconn structure
+#include "esp_system.h" // for esp_random
+#include "mbedtls/base64.h"
+#include "mbedtls/sha1.h"
+#include <stdint.h>
+#include <string.h>
+
+#define WS_MASK_PIECE 128 // stack buffer for masking in ws_send()
+
+#define WS_MAX_MESSAGE CONFIG_WEBSOCKET_MAX_MESSAGE_SIZE
+#define WS_MAX_TOTAL CONFIG_WEBSOCKET_MAX_TOTAL_SIZE
+
+// memory held by the parsers of all clients, limited to WS_MAX_TOTAL
+static size_t ws_mem_used;
+
+// machine word for ws_mask(), may alias the byte buffer
+#if UINTPTR_MAX > 0xFFFFFFFF
+typedef uint64_t __attribute__((may_alias)) ws_mask_word_t;
+#else
+typedef uint32_t __attribute__((may_alias)) ws_mask_word_t;
+#endif
+
+// takes n bytes from the budget of all clients, false if it is exhausted
+static bool ws_mem_reserve(size_t n) {
+  size_t used = __atomic_add_fetch(&ws_mem_used,n,__ATOMIC_RELAXED);
+  if(used <= WS_MAX_TOTAL) return 1;
+  __atomic_sub_fetch(&ws_mem_used,n,__ATOMIC_RELAXED);
+  return 0;
+}
+
+static void ws_mem_release(size_t n) {
+  __atomic_sub_fetch(&ws_mem_used,n,__ATOMIC_RELAXED);
+}
+
+ws_client_t ws_connect_client(struct netconn* conn,
+                              char* url,
+                              void (*ccallback)(WEBSOCKET_TYPE_t type,char* msg,uint64_t len),
+                              void (*scallback)(uint8_t num,WEBSOCKET_TYPE_t type,char* msg,uint64_t len)
+                            ) {
+  ws_client_t client;
+  client.conn = conn;
+  client.url  = url;
+  client.ping = 0;
+  client.last_opcode = 0;
+  client.contin = NULL;
+  client.len = 0;
+  client.contin_size = 0;
+  memset(&client.parser,0,sizeof(client.parser));
+  client.ccallback = ccallback;
+  client.scallback = scallback;
+  return client;
+}
+
+void ws_disconnect_client(ws_client_t* client,bool mask) {
+  char status[2] = {client->parser.error >> 8,client->parser.error & 0xFF};
+  ws_send(client,WEBSOCKET_OPCODE_CLOSE,status,client->parser.error ? 2 : 0,mask); // tell the client to close, and why
+  if(client->conn) {
+    client->conn->callback = NULL; // shut off the callback
+    netconn_close(client->conn);
+    netconn_delete(client->conn);
+    client->conn = NULL;
+  }
+  client->url = NULL;
+  client->last_opcode = 0;
+  if(client->contin) {
+    free(client->contin);
+    ws_mem_release(client->contin_size);
+    client->contin = NULL;
+  }
+  client->len = 0;
+  client->contin_size = 0;
+  if(client->parser.payload && !client->parser.to_contin) {
+    free(client->parser.payload);
+    ws_mem_release(client->parser.header.length+1);
+  }
+  if(client->parser.inbuf) netbuf_delete(client->parser.inbuf);
+  memset(&client->parser,0,sizeof(client->parser));
+  client->ccallback = NULL;
+  client->scallback = NULL;
+}
+
+bool ws_is_connected(ws_client_t client) {
+  if(client.conn)
+    return 1;
+  return 0;
+}
+
+static void ws_generate_mask(ws_header_t* header) {
+  header->param.bit.MASK = 1;
+  header->key.full = esp_random(); // generate a random 32 bit number
+}
+
+void ws_mask(char* msg,uint64_t len,uint32_t key,uint64_t offset) {
+  uint8_t* p = (uint8_t*)msg;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // key as loaded from key.part[], rotated so the low byte belongs to msg[0]
+  uint32_t rot = (offset & 3) * 8;
+  uint32_t k = rot ? (key >> rot) | (key << (32 - rot)) : key;
+
+  // bytes up to the first aligned word
+  while(len && ((uintptr_t)p & (sizeof(ws_mask_word_t) - 1))) {
+    *p++ ^= k & 0xFF;
+    k = (k >> 8) | (k << 24);
+    len--;
+  }
+
+  // the key repeats every 4 bytes, so a word needs no rotation
+  ws_mask_word_t kw = k;
+  if(sizeof(kw) == 8) kw |= kw << 16 << 16;
+  ws_mask_word_t* w = (ws_mask_word_t*)p;
+  for(; len >= 4 * sizeof(kw); len -= 4 * sizeof(kw), w += 4) {
+    w[0] ^= kw; w[1] ^= kw; w[2] ^= kw; w[3] ^= kw;
+  }
+  for(; len >= sizeof(kw); len -= sizeof(kw)) {
+    *w++ ^= kw;
+  }
+
+  // tail, starting at a multiple of the word size, so with k as it is
+  p = (uint8_t*)w;
+  while(len--) {
+    *p++ ^= k & 0xFF;
+    k = (k >> 8) | (k << 24);
+  }
+#else
+  const uint8_t* part = (const uint8_t*)&key;
+  for(uint64_t i=0; i<len; i++) {
+    p[i] ^= part[(offset + i) % 4];
+  }
+#endif
+}
+
+static void ws_encrypt_decrypt(char* msg,ws_header_t header) {
+  if(header.param.bit.MASK) {
+    ws_mask(msg,header.length,header.key.full,0);
+  }
+}
+
+// fills in the frame header, returns its length (at most WEBSOCKET_HEADER_MAX)
+static size_t ws_build_header(uint8_t* out,ws_header_t* header,WEBSOCKET_OPCODES_t opcode,uint64_t len,bool mask) {
+  size_t pos = 2;
+
+  header->param.pos.ZERO = 0; // reset the whole header
+  header->param.pos.ONE  = 0;
+
+  header->param.bit.FIN = 1; // all pieces are done (you don't need a huge message anyway...)
+  header->param.bit.OPCODE = opcode;
+  // populate LEN field
+  header->length = len;
+  if(len<=125) {
+    header->param.bit.LEN = len;
+  }
+  else if(len<65536) {
+    header->param.bit.LEN = 126;
+    out[2] = (len >> 8) & 0xFF;
+    out[3] = (len     ) & 0xFF;
+    pos = 4;
+  }
+  else {
+    header->param.bit.LEN = 127;
+    out[2] = (len >> 56) & 0xFF;
+    out[3] = (len >> 48) & 0xFF;
+    out[4] = (len >> 40) & 0xFF;
+    out[5] = (len >> 32) & 0xFF;
+    out[6] = (len >> 24) & 0xFF;
+    out[7] = (len >> 16) & 0xFF;
+    out[8] = (len >> 8)  & 0xFF;
+    out[9] = (len)       & 0xFF;
+    pos = 10;
+  }
+
+  if(mask) {
+    ws_generate_mask(header); // get a key
+    memcpy(&out[pos],header->key.part,4);
+    pos += 4;
+  }
+
+  out[0] = header->param.pos.ZERO; // after the mask bit is set
+  out[1] = header->param.pos.ONE;
+  return pos;
+}
+
+void ws_frame_encode(ws_frame_t* frame,WEBSOCKET_OPCODES_t opcode,const char* msg,uint64_t len) {
+  ws_header_t header;
+  frame->hdr_len = ws_build_header(frame->hdr,&header,opcode,len,0);
+  frame->msg = msg;
+  frame->len = len;
+}
+
+int ws_send_frame(ws_client_t* client,const ws_frame_t* frame) {
+  // header and payload in one write, copied once into the send buffer
+  struct netvector vec[2] = {
+    {.ptr = frame->hdr, .len = frame->hdr_len},
+    {.ptr = frame->msg, .len = frame->len}
+  };
+  return netconn_write_vectors_partly(client->conn,vec,frame->len ? 2 : 1,NETCONN_COPY,NULL);
+}
+
+int ws_send(ws_client_t* client,WEBSOCKET_OPCODES_t opcode,char* msg,uint64_t len,bool mask) {
+  uint8_t out[WEBSOCKET_HEADER_MAX];
+  ws_header_t header;
+  size_t pos;
+  int ret;
+
+  if(!mask) {
+    ws_frame_t frame;
+    ws_frame_encode(&frame,opcode,msg,len);
+    return ws_send_frame(client,&frame);
+  }
+
+  pos = ws_build_header(out,&header,opcode,len,mask);
+
+  // the caller's buffer stays untouched, the payload is masked in pieces on the stack
+  char piece[WS_MASK_PIECE] __attribute__((aligned(4)));
+  ret = netconn_write(client->conn,out,pos,NETCONN_COPY | (len ? NETCONN_MORE : 0));
+  for(uint64_t i=0; ret==ERR_OK && i<len; i+=sizeof(piece)) {
+    size_t n = len-i < sizeof(piece) ? len-i : sizeof(piece);
+    memcpy(piece,&msg[i],n);
+    ws_mask(piece,n,header.key.full,i);
+    ret = netconn_write(client->conn,piece,n,NETCONN_COPY | (i+n<len ? NETCONN_MORE : 0));
+  }
+  return ret;
+}
+
+int ws_send_nocopy(ws_client_t* client,WEBSOCKET_OPCODES_t opcode,char* msg,uint64_t len,bool mask) {
+  uint8_t out[WEBSOCKET_HEADER_MAX];
+  ws_header_t header;
+  size_t pos;
+  int ret;
+
+  pos = ws_build_header(out,&header,opcode,len,mask);
+  ws_encrypt_decrypt(msg,header); // in place, if necessary
+
+  // the header lives on the stack, so it is copied. one flag set per write, hence two writes.
+  ret = netconn_write(client->conn,out,pos,NETCONN_COPY | (len ? NETCONN_MORE : 0));
+  if(ret==ERR_OK && len)
+    ret = netconn_write(client->conn,msg,len,NETCONN_NOCOPY);
+  return ret;
+}
+
+// header size, from its first two bytes
+static uint8_t ws_header_len(const uint8_t* hdr) {
+  uint8_t len = 2;
+  if((hdr[1] & 0x7F) == 126) len += 2;
+  if((hdr[1] & 0x7F) == 127) len += 8;
+  if(hdr[1] & 0x80) len += 4;
+  return len;
+}
+
+static void ws_decode_header(const uint8_t* buf,ws_header_t* header) {
+  uint8_t pos = 2;
+
+  header->param.pos.ZERO = buf[0];
+  header->param.pos.ONE  = buf[1];
+
+  // get the message length
+  if(header->param.bit.LEN <= 125) {
+    header->length = header->param.bit.LEN;
+  }
+  else if(header->param.bit.LEN == 126) {
+    header->length = buf[2] << 8 | buf[3];
+    pos = 4;
+  }
+  else { // LEN = 127
+    header->length = (uint64_t)buf[2] << 56 | (uint64_t)buf[3] << 48
+                   | (uint64_t)buf[4] << 40 | (uint64_t)buf[5] << 32
+                   | (uint64_t)buf[6] << 24 | (uint64_t)buf[7] << 16
+                   | (uint64_t)buf[8] << 8  | (uint64_t)buf[9];
+    pos = 10;
+  }
+
+  if(header->param.bit.MASK) {
+    memcpy(&(header->key.full),&buf[pos],4); // extract the key
+  }
+}
+
+// decides where the payload of a new frame goes: its own buffer, or appended to the
+// fragmented message in client->contin. sets parser.error if the frame can't be taken.
+static void ws_frame_begin(ws_client_t* client) {
+  ws_parser_t* p = &client->parser;
+  ws_header_t* h = &p->header;
+  uint8_t opcode = h->param.bit.OPCODE;
+
+  p->pos = 0;
+  p->payload = NULL;
+  p->to_contin = 0;
+  p->state = WEBSOCKET_PARSE_PAYLOAD;
+
+  if(opcode >= WEBSOCKET_OPCODE_CLOSE) { // control frames are short and never fragmented
+    if(h->length > 125 || !h->param.bit.FIN) p->error = WEBSOCKET_CLOSE_PROTOCOL_ERROR;
+  }
+  else if(opcode == WEBSOCKET_OPCODE_CONT) {
+    if(!client->contin) p->error = WEBSOCKET_CLOSE_PROTOCOL_ERROR; // nothing to continue
+  }
+  else if(client->contin) {
+    p->error = WEBSOCKET_CLOSE_PROTOCOL_ERROR; // new message before the last one finished
+  }
+  if(p->error) return;
+
+  if(opcode != WEBSOCKET_OPCODE_CONT) {
+    if(h->length > WS_MAX_MESSAGE || !ws_mem_reserve(h->length+1)) {
+      p->error = WEBSOCKET_CLOSE_TOO_BIG;
+      return;
+    }
+    p->payload = malloc(h->length+1); // plus a byte for the terminator
+    if(!p->payload) { // out of heap: skip a control frame, give up on a message
+      ws_mem_release(h->length+1);
+      if(opcode >= WEBSOCKET_OPCODE_CLOSE) p->state = WEBSOCKET_PARSE_DISCARD;
+      else p->error = WEBSOCKET_CLOSE_TOO_BIG;
+    }
+    return;
+  }
+
+  // continuation: grow the message geometrically, so the whole message is copied O(1) times.
+  // the length comes from the peer, check it before adding so it can't wrap around
+  if(h->length > WS_MAX_MESSAGE - client->len) {
+    p->error = WEBSOCKET_CLOSE_TOO_BIG;
+    return;
+  }
+  uint64_t need = client->len + h->length + 1;
+  if(need > client->contin_size) {
+    size_t size = client->contin_size * 2;
+    if(size < need) size = need;
+    if(size > WS_MAX_MESSAGE + 1) size = WS_MAX_MESSAGE + 1;
+    char* grown = NULL;
+    if(ws_mem_reserve(size - client->contin_size)) {
+      grown = realloc(client->contin,size);
+      if(!grown) ws_mem_release(size - client->contin_size);
+    }
+    if(!grown) {
+      p->error = WEBSOCKET_CLOSE_TOO_BIG;
+      return;
+    }
+    client->contin = grown;
+    client->contin_size = size;
+  }
+  p->payload = &client->contin[client->len];
+  p->to_contin = 1;
+}
+
+// consumes up to len bytes, returns how many. stops after a complete frame, which is then
+// left in parser->header and parser->payload
+static size_t ws_parse(ws_client_t* client,const uint8_t* data,size_t len,bool* done) {
+  ws_parser_t* p = &client->parser;
+  size_t used = 0;
+  size_t n;
+
+  *done = 0;
+  while(used < len && !*done && !p->error) {
+    if(p->state == WEBSOCKET_PARSE_HEADER) {
+      uint8_t need = p->hdr_len < 2 ? 2 : ws_header_len(p->hdr);
+      n = need - p->hdr_len;
+      if(n > len - used) n = len - used;
+      memcpy(&p->hdr[p->hdr_len],&data[used],n);
+      p->hdr_len += n;
+      used += n;
+      if(p->hdr_len < need || p->hdr_len < ws_header_len(p->hdr)) continue;
+
+      ws_decode_header(p->hdr,&p->header);
+      p->hdr_len = 0;
+      if(p->header.length >> 63) { // the most significant bit must be 0 (RFC 6455 5.2)
+        p->error = WEBSOCKET_CLOSE_PROTOCOL_ERROR;
+        break;
+      }
+      ws_frame_begin(client);
+      if(p->error) break;
+    }
+    else {
+      n = len - used;
+      if(n > p->header.length - p->pos) n = p->header.length - p->pos;
+      if(p->payload) memcpy(&p->payload[p->pos],&data[used],n);
+      p->pos += n;
+      used += n;
+    }
+
+    // empty payloads are complete right after the header
+    if(p->state != WEBSOCKET_PARSE_HEADER && p->pos == p->header.length) {
+      *done = p->state == WEBSOCKET_PARSE_PAYLOAD;
+      p->state = WEBSOCKET_PARSE_HEADER;
+    }
+  }
+  return used;
+}
+
+err_t ws_recv(ws_client_t* client) {
+  if(client->parser.inbuf) return ERR_OK; // ws_read has data left
+  return netconn_recv(client->conn,&client->parser.inbuf);
+}
+
+// parses the received data up to the end of the next frame
+static bool ws_next_frame(ws_client_t* client) {
+  ws_parser_t* p = &client->parser;
+  char* buf;
+  uint16_t len;
+  bool done = 0;
+
+  while(p->inbuf && !done && !p->error) {
+    netbuf_data(p->inbuf,(void**)&buf,&len);
+    p->in_pos += ws_parse(client,(uint8_t*)&buf[p->in_pos],len - p->in_pos,&done);
+    if(p->in_pos == len) { // this piece is parsed, go on with the next one of the chain
+      p->in_pos = 0;
+      if(netbuf_next(p->inbuf) < 0) {
+        netbuf_delete(p->inbuf);
+        p->inbuf = NULL;
+      }
+    }
+  }
+  if(done) ws_encrypt_decrypt(p->payload,p->header); // unencrypt, if necessary
+  return done;
+}
+
+char* ws_read(ws_client_t* client,ws_header_t* header) {
+  ws_parser_t* p = &client->parser;
+  char* ret;
+
+  header->received = 0;
+  while(ws_next_frame(client)) {
+    *header = p->header;
+    ret = p->payload;
+    p->payload = NULL;
+
+    if(p->to_contin) { // the piece is in place already
+      client->len += header->length;
+      if(!header->param.bit.FIN) continue;
+
+      // the message is complete, hand it over with the opcode of its first frame
+      ret = client->contin;
+      header->length = client->len;
+      header->param.bit.OPCODE = client->contin_text ? WEBSOCKET_OPCODE_TEXT : WEBSOCKET_OPCODE_BIN;
+      ws_mem_release(client->contin_size);
+      client->contin = NULL;
+      client->contin_size = 0;
+      client->len = 0;
+    }
+    else if(!header->param.bit.FIN) { // the first piece of a message, the others are appended to it
+      client->contin = ret; // along with its share of the memory budget
+      client->contin_size = header->length+1;
+      client->len = header->length;
+      client->contin_text = header->param.bit.OPCODE == WEBSOCKET_OPCODE_TEXT;
+      continue;
+    }
+    else {
+      ws_mem_release(header->length+1); // the caller owns it now
+    }
+
+    ret[header->length] = '\0'; // end string
+    client->last_opcode = header->param.bit.OPCODE;
+    header->received = 1;
+    return ret;
+  }
+  return NULL;
+}
+
+char* ws_hash_handshake(char* handshake,uint8_t len) {
+  const char hash[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  const uint8_t hash_len = sizeof(hash);
+  char* ret;
+  char key[64];
+  unsigned char sha1sum[20];
+  size_t ret_len;
+
+  if(!len) return NULL;
+  ret = malloc(32);
+
+  memcpy(key,handshake,len);
+  strlcpy(&key[len],hash,sizeof(key));
+  mbedtls_sha1((unsigned char*)key,len+hash_len-1,sha1sum);
+  mbedtls_base64_encode(NULL, 0, &ret_len, sha1sum, 20);
+  if(!mbedtls_base64_encode((unsigned char*)ret,32,&ret_len,sha1sum,20)) {
+    ret[ret_len] = '\0';
+    return ret;
+  }
+  free(ret);
+  return NULL;
+}
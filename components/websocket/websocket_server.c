@@ -1,370 +1,449 @@
-
-/*
-esp32-websocket - a websocket component on esp-idf
-Copyright (C) 2019 Blake Felt - blake.w.felt@gmail.com
-
-This program is free software: you can redistribute it and/or modify
-    it under the terms of the GNU General Public License as published by
-    the Free Software Foundation, either version 3 of the License, or
-    (at your option) any later version.
-
-    This program is distributed in the hope that it will be useful,
-    but WITHOUT ANY WARRANTY; without even the implied warranty of
-    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-    GNU General Public License for more details.
-
-    You should have received a copy of the GNU General Public License
-    along with this program.  If not, see <https://www.gnu.org/licenses/>.
-*/
-
-#include "websocket_server.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
-#include "freertos/task.h"
-#include "freertos/queue.h"
-#include <string.h>
-
-static SemaphoreHandle_t xwebsocket_mutex; // to lock the client array
-static QueueHandle_t xwebsocket_queue; // to hold the clients that send messages
-static ws_client_t clients[WEBSOCKET_SERVER_MAX_CLIENTS]; // holds list of clients
-static TaskHandle_t xtask; // the task itself
-
-static void background_callback(struct netconn* conn, enum netconn_evt evt,u16_t len) {
-  switch(evt) {
-    case NETCONN_EVT_RCVPLUS:
-      xQueueSendToBack(xwebsocket_queue,&conn,WEBSOCKET_SERVER_QUEUE_TIMEOUT);
-      break;
-    default:
-      break;
-  }
-}
-
-static void handle_read(uint8_t num) {
-  ws_header_t header;
-  char* msg;
-
-  header.received = 0;
-  msg = ws_read(&clients[num],&header);
-
-  if(!header.received) {
-    if(msg) free(msg);
-    return;
-  }
-
-  switch(clients[num].last_opcode) {
-    case WEBSOCKET_OPCODE_CONT:
-      break;
-    case WEBSOCKET_OPCODE_BIN:
-      clients[num].scallback(num,WEBSOCKET_BIN,msg,header.length);
-      break;
-    case WEBSOCKET_OPCODE_TEXT:
-      clients[num].scallback(num,WEBSOCKET_TEXT,msg,header.length);
-      break;
-    case WEBSOCKET_OPCODE_PING:
-      ws_send(&clients[num],WEBSOCKET_OPCODE_PONG,msg,header.length,0);
-      clients[num].scallback(num,WEBSOCKET_PING,msg,header.length);
-      break;
-    case WEBSOCKET_OPCODE_PONG:
-      if(clients[num].ping) {
-        clients[num].scallback(num,WEBSOCKET_PONG,NULL,0);
-        clients[num].ping = 0;
-      }
-      break;
-    case WEBSOCKET_OPCODE_CLOSE:
-      clients[num].scallback(num,WEBSOCKET_DISCONNECT_EXTERNAL,NULL,0);
-      ws_disconnect_client(&clients[num], 0);
-      break;
-    default:
-      break;
-  }
-  if(msg) free(msg);
-}
-
-static void ws_server_task(void* pvParameters) {
-  struct netconn* conn;
-
-  xwebsocket_mutex = xSemaphoreCreateMutex();
-  xwebsocket_queue = xQueueCreate(WEBSOCKET_SERVER_QUEUE_SIZE, sizeof(struct netconn*));
-
-  // initialize all clients
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    clients[i].conn = NULL;
-    clients[i].url  = NULL;
-    clients[i].ping = 0;
-    clients[i].last_opcode = 0;
-    clients[i].contin = NULL;
-    clients[i].len = 0;
-    clients[i].ccallback = NULL;
-    clients[i].scallback = NULL;
-  }
-
-  for(;;) {
-    xQueueReceive(xwebsocket_queue,&conn,portMAX_DELAY);
-    if(!conn) continue; // if the connection was NULL, ignore it
-
-    xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY); // take access
-    for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-      if(clients[i].conn == conn) {
-        handle_read(i);
-        break;
-      }
-    }
-    xSemaphoreGive(xwebsocket_mutex); // return access
-  }
-  vTaskDelete(NULL);
-}
-
-int ws_server_start() {
-  if(xtask) return 0;
-  #if WEBSOCKET_SERVER_PINNED
-  xTaskCreatePinnedToCore(&ws_server_task,
-                          "ws_server_task",
-                          WEBSOCKET_SERVER_TASK_STACK_DEPTH,
-                          NULL,
-                          WEBSOCKET_SERVER_TASK_PRIORITY,
-                          &xtask,
-                          WEBSOCKET_SERVER_PINNED_CORE);
-  #else
-  xTaskCreate(&ws_server_task,
-              "ws_server_task",
-              WEBSOCKET_SERVER_TASK_STACK_DEPTH,
-              NULL,
-              WEBSOCKET_SERVER_TASK_PRIORITY,
-              &xtask);
-  #endif
-  return 1;
-}
-
-int ws_server_stop() {
-  if(!xtask) return 0;
-  vTaskDelete(xtask);
-  return 1;
-}
-
-static bool prepare_response(char* buf,uint32_t buflen,char* handshake,char* protocol) {
-  const char WS_HEADER[] = "Upgrade: websocket\r\n";
-  const char WS_KEY[] = "Sec-WebSocket-Key: ";
-  const char WS_RSP[] = "HTTP/1.1 101 Switching Protocols\r\n" \
-                        "Upgrade: websocket\r\n" \
-                        "Connection: Upgrade\r\n" \
-                        "Sec-WebSocket-Accept: %s\r\n" \
-                        "%s\r\n";
-
-  char* key_start;
-  char* key_end;
-  char* hashed_key;
-
-  if(!strstr(buf,WS_HEADER)) return 0;
-  if(!buflen) return 0;
-  key_start = strstr(buf,WS_KEY);
-  if(!key_start) return 0;
-  key_start += 19;
-  key_end = strstr(key_start,"\r\n");
-  if(!key_end) return 0;
-
-  hashed_key = ws_hash_handshake(key_start,key_end-key_start);
-  if(!hashed_key) return 0;
-  if(protocol) {
-    char tmp[256];
-    sprintf(tmp,WS_RSP,hashed_key,"Sec-WebSocket-Protocol: %s\r\n");
-    sprintf(handshake,tmp,protocol);
-  }
-  else {
-    sprintf(handshake,WS_RSP,hashed_key,"");
-  }
-  free(hashed_key);
-  return 1;
-}
-
-int ws_server_add_client_protocol(struct netconn* conn,
-                         char* msg,
-                         uint16_t len,
-                         char* url,
-                         char* protocol,
-                         void (*callback)(uint8_t num,
-                                          WEBSOCKET_TYPE_t type,
-                                          char* msg,
-                                          uint64_t len)) {
-  int ret;
-  char handshake[256];
-
-  if(!prepare_response(msg,len,handshake,protocol)) {
-    netconn_close(conn);
-    netconn_delete(conn);
-    return -2;
-  }
-
-
-  ret = -1;
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  conn->callback = background_callback;
-  netconn_write(conn,handshake,strlen(handshake),NETCONN_COPY);
-
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(clients[i].conn) continue;
-    clients[i] = ws_connect_client(conn,url,NULL,callback);
-    callback(i,WEBSOCKET_CONNECT,NULL,0);
-    if(!ws_is_connected(clients[i])) {
-      callback(i,WEBSOCKET_DISCONNECT_ERROR,NULL,0);
-      ws_disconnect_client(&clients[i], 0);
-      break;
-    }
-    ret = i;
-    break;
-  }
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_len_url(char* url) {
-  int ret;
-  ret = 0;
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(clients[i].url && strcmp(url,clients[i].url)) ret++;
-  }
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_add_client(struct netconn* conn,
-                         char* msg,
-                         uint16_t len,
-                         char* url,
-                         void (*callback)(uint8_t num,
-                                          WEBSOCKET_TYPE_t type,
-                                          char* msg,
-                                          uint64_t len)) {
-
-  return ws_server_add_client_protocol(conn,msg,len,url,NULL,callback);
-
-}
-
-int ws_server_len_all() {
-  int ret;
-  ret = 0;
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(clients[i].conn) ret++;
-  }
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_remove_client(int num) {
-  int ret = 0;
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  if(ws_is_connected(clients[num])) {
-    clients[num].scallback(num,WEBSOCKET_DISCONNECT_INTERNAL,NULL,0);
-    ws_disconnect_client(&clients[num], 0);
-    ret = 1;
-  }
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_remove_clients(char* url) {
-  int ret = 0;
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(ws_is_connected(clients[i]) && strcmp(url,clients[i].url)) {
-      clients[i].scallback(i,WEBSOCKET_DISCONNECT_INTERNAL,NULL,0);
-      ws_disconnect_client(&clients[i], 0);
-      ret += 1;
-    }
-  }
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_remove_all() {
-  int ret = 0;
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(ws_is_connected(clients[i])) {
-      clients[i].scallback(i,WEBSOCKET_DISCONNECT_INTERNAL,NULL,0);
-      ws_disconnect_client(&clients[i], 0);
-      ret += 1;
-    }
-  }
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-// The following functions are already written below, but without the mutex.
-
-int ws_server_send_text_client(int num,char* msg,uint64_t len) {
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  int ret = ws_server_send_text_client_from_callback(num, msg, len);
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_send_text_clients(char* url,char* msg,uint64_t len) {
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  int ret = ws_server_send_text_clients_from_callback(url, msg, len);
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-int ws_server_send_text_all(char* msg,uint64_t len) {
-  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
-  int ret = ws_server_send_text_all_from_callback(msg, len);
-  xSemaphoreGive(xwebsocket_mutex);
-  return ret;
-}
-
-// the following functions should be used inside of the callback. The regular versions
-// grab the mutex, but it is already grabbed from inside the callback so it will hang.
-
-int ws_server_send_text_client_from_callback(int num,char* msg,uint64_t len) {
-  int ret = 0;
-  int err;
-  if(ws_is_connected(clients[num])) {
-    err = ws_send(&clients[num],WEBSOCKET_OPCODE_TEXT,msg,len,0);
-    ret = 1;
-    if(err) {
-      clients[num].scallback(num,WEBSOCKET_DISCONNECT_ERROR,NULL,0);
-      ws_disconnect_client(&clients[num], 0);
-      ret = 0;
-    }
-  }
-  return ret;
-}
-
-int ws_server_send_text_clients_from_callback(char* url,char* msg,uint64_t len) {
-  int ret = 0;
-  int err;
-
-  if(url == NULL) {
-    return ret;
-  }
-
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(clients[i].url != NULL && ws_is_connected(clients[i]) && !strcmp(clients[i].url,url)) {
-      err = ws_send(&clients[i],WEBSOCKET_OPCODE_TEXT,msg,len,0);
-      if(!err) ret += 1;
-      else {
-        clients[i].scallback(i,WEBSOCKET_DISCONNECT_ERROR,NULL,0);
-        ws_disconnect_client(&clients[i], 0);
-      }
-    }
-  }
-  return ret;
-}
-
-int ws_server_send_text_all_from_callback(char* msg,uint64_t len) {
-  int ret = 0;
-  int err;
-  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
-    if(ws_is_connected(clients[i])) {
-      err = ws_send(&clients[i],WEBSOCKET_OPCODE_TEXT,msg,len,0);
-      if(!err) ret += 1;
-      else {
-        clients[i].scallback(i,WEBSOCKET_DISCONNECT_ERROR,NULL,0);
-        ws_disconnect_client(&clients[i], 0);
-      }
-    }
-  }
-  return ret;
-}
+
+/*
+esp32-websocket - a websocket component on esp-idf
+Copyright (C) 2019 Blake Felt - blake.w.felt@gmail.com
+
+This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "websocket_server.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <string.h>
+
+static SemaphoreHandle_t xwebsocket_mutex; // to lock the client array
+static QueueHandle_t xwebsocket_queue; // to hold the clients that send messages
+static ws_client_t clients[WEBSOCKET_SERVER_MAX_CLIENTS]; // holds list of clients
+static TaskHandle_t xtask; // the task itself
+
+// conn -> slot lookup, so a received segment doesn't scan all clients.
+// open addressing with linear probing, entries are slot+1 (0 is empty).
+// the table is kept at most half full, so probes stay short at any client count
+#define SLOT_TABLE_SIZE (2*WEBSOCKET_SERVER_MAX_CLIENTS+1)
+static uint16_t slot_table[SLOT_TABLE_SIZE];
+static uint16_t slot_pos[WEBSOCKET_SERVER_MAX_CLIENTS]; // table index of each slot, SLOT_NONE if not in it
+static uint16_t free_slots[WEBSOCKET_SERVER_MAX_CLIENTS]; // stack of unused slots
+static uint16_t free_count;
+#define SLOT_NONE 0xFFFF
+
+static uint32_t slot_home(struct netconn* conn) {
+  return (uint32_t)(((uintptr_t)conn >> 2) * 2654435761u) % SLOT_TABLE_SIZE;
+}
+
+static int slot_find(struct netconn* conn) {
+  for(uint32_t i=slot_home(conn);slot_table[i];i = (i+1) % SLOT_TABLE_SIZE) {
+    if(clients[slot_table[i]-1].conn == conn) return slot_table[i]-1;
+  }
+  return -1;
+}
+
+static void slot_insert(int num) {
+  uint32_t i = slot_home(clients[num].conn);
+  while(slot_table[i]) i = (i+1) % SLOT_TABLE_SIZE;
+  slot_table[i] = num+1;
+  slot_pos[num] = i;
+}
+
+// removes the entry of num and gives the slot back, once. found by its stored position,
+// so it works after clients[num].conn was cleared. later entries of the probe run are
+// shifted back instead of leaving tombstones
+static void slot_remove(int num) {
+  uint32_t i = slot_pos[num];
+  uint32_t j,k;
+  if(i == SLOT_NONE) return;
+  for(j=i;;) {
+    j = (j+1) % SLOT_TABLE_SIZE;
+    if(!slot_table[j]) break;
+    k = slot_home(clients[slot_table[j]-1].conn);
+    if(i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue; // still reachable from its home
+    slot_table[i] = slot_table[j];
+    slot_pos[slot_table[i]-1] = i;
+    i = j;
+  }
+  slot_table[i] = 0;
+  slot_pos[num] = SLOT_NONE;
+  free_slots[free_count++] = num;
+}
+
+// calls the callback, then disconnects the client and gives its slot back
+static void close_client(int num,WEBSOCKET_TYPE_t type) {
+  clients[num].scallback(num,type,NULL,0);
+  slot_remove(num);
+  ws_disconnect_client(&clients[num], 0);
+}
+
+static void background_callback(struct netconn* conn, enum netconn_evt evt,u16_t len) {
+  switch(evt) {
+    case NETCONN_EVT_RCVPLUS:
+      xQueueSendToBack(xwebsocket_queue,&conn,WEBSOCKET_SERVER_QUEUE_TIMEOUT);
+      break;
+    default:
+      break;
+  }
+}
+
+static void handle_read(int num) {
+  ws_header_t header;
+  char* msg;
+
+  if(ws_recv(&clients[num]) != ERR_OK) return;
+
+  // a segment can carry any number of frames, or just a part of one
+  while(clients[num].conn && (msg = ws_read(&clients[num],&header))) {
+    switch(clients[num].last_opcode) {
+      case WEBSOCKET_OPCODE_CONT:
+        break;
+      case WEBSOCKET_OPCODE_BIN:
+        clients[num].scallback(num,WEBSOCKET_BIN,msg,header.length);
+        break;
+      case WEBSOCKET_OPCODE_TEXT:
+        clients[num].scallback(num,WEBSOCKET_TEXT,msg,header.length);
+        break;
+      case WEBSOCKET_OPCODE_PING:
+        ws_send(&clients[num],WEBSOCKET_OPCODE_PONG,msg,header.length,0);
+        clients[num].scallback(num,WEBSOCKET_PING,msg,header.length);
+        break;
+      case WEBSOCKET_OPCODE_PONG:
+        if(clients[num].ping) {
+          clients[num].scallback(num,WEBSOCKET_PONG,NULL,0);
+          clients[num].ping = 0;
+        }
+        break;
+      case WEBSOCKET_OPCODE_CLOSE:
+        close_client(num,WEBSOCKET_DISCONNECT_EXTERNAL);
+        break;
+      default:
+        break;
+    }
+    free(msg);
+  }
+
+  // the stream can't be parsed on, e.g. a message over the size limit
+  if(clients[num].conn && clients[num].parser.error) {
+    close_client(num,WEBSOCKET_DISCONNECT_ERROR);
+  }
+}
+
+static void ws_server_task(void* pvParameters) {
+  struct netconn* conn;
+
+  xwebsocket_mutex = xSemaphoreCreateMutex();
+  xwebsocket_queue = xQueueCreate(WEBSOCKET_SERVER_QUEUE_SIZE, sizeof(struct netconn*));
+
+  // initialize all clients
+  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
+    clients[i].conn = NULL;
+    clients[i].url  = NULL;
+    clients[i].ping = 0;
+    clients[i].last_opcode = 0;
+    clients[i].contin = NULL;
+    clients[i].len = 0;
+    clients[i].contin_size = 0;
+    memset(&clients[i].parser,0,sizeof(clients[i].parser));
+    clients[i].ccallback = NULL;
+    clients[i].scallback = NULL;
+  }
+  memset(slot_table,0,sizeof(slot_table));
+  free_count = 0;
+  for(int i=WEBSOCKET_SERVER_MAX_CLIENTS-1;i>=0;i--) {
+    slot_pos[i] = SLOT_NONE;
+    free_slots[free_count++] = i; // lowest slot first
+  }
+
+  for(;;) {
+    int num;
+    xQueueReceive(xwebsocket_queue,&conn,portMAX_DELAY);
+    if(!conn) continue; // if the connection was NULL, ignore it
+
+    xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY); // take access
+    num = slot_find(conn);
+    if(num >= 0) handle_read(num);
+    xSemaphoreGive(xwebsocket_mutex); // return access
+  }
+  vTaskDelete(NULL);
+}
+
+int ws_server_start() {
+  #if WEBSOCKET_SERVER_PINNED
+  return ws_server_start_pinned(WEBSOCKET_SERVER_PINNED_CORE,WEBSOCKET_SERVER_TASK_PRIORITY);
+  #else
+  return ws_server_start_pinned(tskNO_AFFINITY,WEBSOCKET_SERVER_TASK_PRIORITY);
+  #endif
+}
+
+int ws_server_start_pinned(BaseType_t core,UBaseType_t priority) {
+  if(xtask) return 0;
+  xTaskCreatePinnedToCore(&ws_server_task,
+                          "ws_server_task",
+                          WEBSOCKET_SERVER_TASK_STACK_DEPTH,
+                          NULL,
+                          priority,
+                          &xtask,
+                          core);
+  return 1;
+}
+
+int ws_server_stop() {
+  if(!xtask) return 0;
+  vTaskDelete(xtask);
+  xtask = NULL;
+  return 1;
+}
+
+TaskHandle_t ws_server_get_task() {
+  return xtask;
+}
+
+static bool prepare_response(char* buf,uint32_t buflen,char* handshake,char* protocol) {
+  const char WS_HEADER[] = "Upgrade: websocket\r\n";
+  const char WS_KEY[] = "Sec-WebSocket-Key: ";
+  const char WS_RSP[] = "HTTP/1.1 101 Switching Protocols\r\n" \
+                        "Upgrade: websocket\r\n" \
+                        "Connection: Upgrade\r\n" \
+                        "Sec-WebSocket-Accept: %s\r\n" \
+                        "%s\r\n";
+
+  char* key_start;
+  char* key_end;
+  char* hashed_key;
+
+  if(!strstr(buf,WS_HEADER)) return 0;
+  if(!buflen) return 0;
+  key_start = strstr(buf,WS_KEY);
+  if(!key_start) return 0;
+  key_start += 19;
+  key_end = strstr(key_start,"\r\n");
+  if(!key_end) return 0;
+
+  hashed_key = ws_hash_handshake(key_start,key_end-key_start);
+  if(!hashed_key) return 0;
+  if(protocol) {
+    char tmp[256];
+    sprintf(tmp,WS_RSP,hashed_key,"Sec-WebSocket-Protocol: %s\r\n");
+    sprintf(handshake,tmp,protocol);
+  }
+  else {
+    sprintf(handshake,WS_RSP,hashed_key,"");
+  }
+  free(hashed_key);
+  return 1;
+}
+
+int ws_server_add_client_protocol(struct netconn* conn,
+                         char* msg,
+                         uint16_t len,
+                         char* url,
+                         char* protocol,
+                         void (*callback)(uint8_t num,
+                                          WEBSOCKET_TYPE_t type,
+                                          char* msg,
+                                          uint64_t len)) {
+  int ret;
+  char handshake[256];
+
+  if(!prepare_response(msg,len,handshake,protocol)) {
+    netconn_close(conn);
+    netconn_delete(conn);
+    return -2;
+  }
+
+
+  ret = -1;
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  conn->callback = background_callback;
+  netconn_write(conn,handshake,strlen(handshake),NETCONN_COPY);
+
+  if(free_count) {
+    int i = free_slots[--free_count];
+    clients[i] = ws_connect_client(conn,url,NULL,callback);
+    slot_insert(i);
+    callback(i,WEBSOCKET_CONNECT,NULL,0);
+    if(ws_is_connected(clients[i])) ret = i;
+    else if(slot_pos[i] != SLOT_NONE) close_client(i,WEBSOCKET_DISCONNECT_ERROR); // unless the callback closed it
+  }
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_len_url(char* url) {
+  int ret;
+  ret = 0;
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
+    if(clients[i].url && strcmp(url,clients[i].url)) ret++;
+  }
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_add_client(struct netconn* conn,
+                         char* msg,
+                         uint16_t len,
+                         char* url,
+                         void (*callback)(uint8_t num,
+                                          WEBSOCKET_TYPE_t type,
+                                          char* msg,
+                                          uint64_t len)) {
+
+  return ws_server_add_client_protocol(conn,msg,len,url,NULL,callback);
+
+}
+
+int ws_server_len_all() {
+  int ret;
+  ret = 0;
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
+    if(clients[i].conn) ret++;
+  }
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_remove_client(int num) {
+  int ret = 0;
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  if(ws_is_connected(clients[num])) {
+    close_client(num,WEBSOCKET_DISCONNECT_INTERNAL);
+    ret = 1;
+  }
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_remove_clients(char* url) {
+  int ret = 0;
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
+    if(ws_is_connected(clients[i]) && strcmp(url,clients[i].url)) {
+      close_client(i,WEBSOCKET_DISCONNECT_INTERNAL);
+      ret += 1;
+    }
+  }
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_remove_all() {
+  int ret = 0;
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
+    if(ws_is_connected(clients[i])) {
+      close_client(i,WEBSOCKET_DISCONNECT_INTERNAL);
+      ret += 1;
+    }
+  }
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+// sends an encoded frame to one client, disconnects it on error. returns 1 if sent
+static int send_frame_client(int num,const ws_frame_t* frame) {
+  if(!ws_is_connected(clients[num])) return 0;
+  if(ws_send_frame(&clients[num],frame)) {
+    close_client(num,WEBSOCKET_DISCONNECT_ERROR);
+    return 0;
+  }
+  return 1;
+}
+
+// sends to all clients, or all clients of url. the frame is encoded once for all of them,
+// lwIP copies the payload into each connection's send buffer. returns how many got it
+static int send_frame_clients(char* url,const ws_frame_t* frame) {
+  int ret = 0;
+  for(int i=0;i<WEBSOCKET_SERVER_MAX_CLIENTS;i++) {
+    if(url && (clients[i].url == NULL || strcmp(clients[i].url,url))) continue;
+    ret += send_frame_client(i,frame);
+  }
+  return ret;
+}
+
+// The following functions are already written below, but without the mutex.
+
+int ws_server_send_text_client(int num,char* msg,uint64_t len) {
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  int ret = ws_server_send_text_client_from_callback(num, msg, len);
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_send_text_clients(char* url,char* msg,uint64_t len) {
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  int ret = ws_server_send_text_clients_from_callback(url, msg, len);
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_send_text_all(char* msg,uint64_t len) {
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  int ret = ws_server_send_text_all_from_callback(msg, len);
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_send_bin_client(int num,char* msg,uint64_t len) {
+  ws_frame_t frame;
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_BIN,msg,len);
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  int ret = send_frame_client(num,&frame);
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_send_bin_clients(char* url,char* msg,uint64_t len) {
+  ws_frame_t frame;
+  if(url == NULL) return 0;
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_BIN,msg,len);
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  int ret = send_frame_clients(url,&frame);
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+int ws_server_send_bin_all(char* msg,uint64_t len) {
+  ws_frame_t frame;
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_BIN,msg,len);
+  xSemaphoreTake(xwebsocket_mutex,portMAX_DELAY);
+  int ret = send_frame_clients(NULL,&frame);
+  xSemaphoreGive(xwebsocket_mutex);
+  return ret;
+}
+
+// the following functions should be used inside of the callback. The regular versions
+// grab the mutex, but it is already grabbed from inside the callback so it will hang.
+
+int ws_server_send_text_client_from_callback(int num,char* msg,uint64_t len) {
+  ws_frame_t frame;
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_TEXT,msg,len);
+  return send_frame_client(num,&frame);
+}
+
+int ws_server_send_text_clients_from_callback(char* url,char* msg,uint64_t len) {
+  ws_frame_t frame;
+
+  if(url == NULL) {
+    return 0;
+  }
+
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_TEXT,msg,len);
+  return send_frame_clients(url,&frame);
+}
+
+int ws_server_send_text_all_from_callback(char* msg,uint64_t len) {
+  ws_frame_t frame;
+  ws_frame_encode(&frame,WEBSOCKET_OPCODE_TEXT,msg,len);
+  return send_frame_clients(NULL,&frame);
+}
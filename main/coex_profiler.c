@@ -0,0 +1,473 @@
+/**
+ * @file coex_profiler.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "coex_profiler.h"
+
+#if COEX_PROFILER_ENABLED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_event.h"
+#include "esp_wifi.h"
+#include "esp_log.h"
+
+#include "disp_driver.h"
+#include "disp_spi.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "coex_profiler"
+
+#define TRACE_LEN       CONFIG_COEX_PROFILER_TRACE_LEN
+#define REPORT_PERIOD   CONFIG_COEX_PROFILER_REPORT_PERIOD_MS
+#define WIFI_WINDOW_US  (CONFIG_COEX_PROFILER_WIFI_WINDOW_MS * 1000)
+
+#define PHASE_BINS      8       /* resolution of the beacon phase histogram */
+#define TU_US           1024    /* one 802.11 time unit */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t t_us;
+    uint32_t val;
+    uint16_t arg;
+    uint8_t type;
+    uint8_t core;
+} coex_entry_t;
+
+typedef struct {
+    coex_entry_t * entries;
+    uint32_t count;
+    uint32_t dropped;
+} coex_buf_t;
+
+/* The three quantities whose jitter is attributed */
+typedef enum {
+    METRIC_FLUSH = 0,   /* flush_cb entry to end of the color transaction */
+    METRIC_RENDER,      /* lv_task_handler() run time */
+    METRIC_WAKE,        /* GUI task wake-up latency */
+    METRIC_NUM
+} coex_metric_t;
+
+typedef struct {
+    uint32_t n;
+    uint32_t max;
+    uint64_t sum;
+    uint64_t sum_sq;
+} coex_stat_t;
+
+typedef struct {
+    coex_stat_t stat[METRIC_NUM][2];        /* [metric][near Wi-Fi] */
+    uint64_t excess[METRIC_NUM][2];         /* time above the quiet mean */
+    uint64_t phase_excess[PHASE_BINS];      /* flush excess by beacon phase */
+    uint32_t mean_quiet[METRIC_NUM];
+    uint32_t wifi_events;
+    uint32_t wifi_rx;
+} coex_summary_t;
+
+/* One sample handed to the analysis passes */
+typedef struct {
+    coex_metric_t metric;
+    uint32_t value;
+    uint32_t from;      /* start of the interval the sample covers (trace relative) */
+    uint32_t to;        /* end of that interval */
+    uint32_t t_abs;     /* absolute start time, for the beacon phase */
+} coex_sample_t;
+
+typedef void (*coex_visit_cb_t)(const coex_sample_t * s, bool near, coex_summary_t * sum);
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void IRAM_ATTR flush_done(void);
+static void wifi_event_cb(void * arg, esp_event_base_t base, int32_t id, void * data);
+#if CONFIG_COEX_PROFILER_SNIFF_RX
+static void wifi_rx_cb(void * buf, wifi_promiscuous_pkt_type_t type);
+#endif
+static void report_task(void * arg);
+static coex_buf_t * swap_buffers(void);
+static void analyse(const coex_buf_t * b);
+static void walk_samples(const coex_buf_t * b, coex_visit_cb_t cb, coex_summary_t * sum);
+static bool near_wifi(uint32_t from, uint32_t to);
+static void visit_stat(const coex_sample_t * s, bool near, coex_summary_t * sum);
+static void visit_excess(const coex_sample_t * s, bool near, coex_summary_t * sum);
+static void print_metric(const char * name, const coex_summary_t * sum, coex_metric_t m);
+static void print_core_load(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static portMUX_TYPE trace_mux = portMUX_INITIALIZER_UNLOCKED;
+static coex_buf_t bufs[2];
+static coex_buf_t * volatile active;
+
+/* Wi-Fi timestamps of the buffer being analysed, trace relative and sorted */
+static uint32_t * wifi_ts;
+static uint32_t wifi_ts_cnt;
+
+static uint32_t beacon_period_us;
+static disp_spi_flush_done_cb_t chained_flush_done;
+
+static const char * metric_names[METRIC_NUM] = {"flush", "render", "gui wake"};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Allocate the trace buffers, hook Wi-Fi and SPI and start the report task.
+ * Call after Wi-Fi has been started and the display driver initialized.
+ */
+void coex_profiler_init(void)
+{
+    for(int i = 0; i < 2; i++) {
+        bufs[i].entries = calloc(TRACE_LEN, sizeof(coex_entry_t));
+        assert(bufs[i].entries != NULL);
+    }
+    wifi_ts = calloc(TRACE_LEN, sizeof(uint32_t));
+    assert(wifi_ts != NULL);
+
+    wifi_mode_t mode;
+    if(esp_wifi_get_mode(&mode) == ESP_OK && (mode == WIFI_MODE_AP || mode == WIFI_MODE_APSTA)) {
+        wifi_config_t cfg;
+        if(esp_wifi_get_config(ESP_IF_WIFI_AP, &cfg) == ESP_OK) {
+            beacon_period_us = (cfg.ap.beacon_interval ? cfg.ap.beacon_interval : 100) * TU_US;
+        }
+    }
+
+    ESP_ERROR_CHECK(esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID, &wifi_event_cb, NULL));
+    ESP_ERROR_CHECK(esp_event_handler_register(IP_EVENT, ESP_EVENT_ANY_ID, &wifi_event_cb, NULL));
+
+#if CONFIG_COEX_PROFILER_SNIFF_RX
+    wifi_promiscuous_filter_t filter = {
+        .filter_mask = WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA,
+    };
+    ESP_ERROR_CHECK(esp_wifi_set_promiscuous_filter(&filter));
+    ESP_ERROR_CHECK(esp_wifi_set_promiscuous_rx_cb(&wifi_rx_cb));
+    ESP_ERROR_CHECK(esp_wifi_set_promiscuous(true));
+#endif
+
+    chained_flush_done = disp_spi_set_flush_done_cb(flush_done);
+
+    active = &bufs[0];
+    xTaskCreate(report_task, "coex_report", 3072, NULL, 1, NULL);
+
+    ESP_LOGI(TAG, "Profiling, report every %d ms, beacon period %u us",
+             REPORT_PERIOD, beacon_period_us);
+}
+
+/**
+ * Append an entry to the trace. Safe to call from tasks and ISRs.
+ * @param type what happened
+ * @param arg event specific tag
+ * @param val event specific value
+ */
+void IRAM_ATTR coex_profiler_record(coex_evt_t type, uint16_t arg, uint32_t val)
+{
+    bool isr = xPortInIsrContext();
+
+    if(isr) portENTER_CRITICAL_ISR(&trace_mux);
+    else portENTER_CRITICAL(&trace_mux);
+
+    coex_buf_t * b = active;
+    if(b) {
+        if(b->count < TRACE_LEN) {
+            coex_entry_t * e = &b->entries[b->count++];
+            e->t_us = (uint32_t) esp_timer_get_time();
+            e->val = val;
+            e->arg = arg;
+            e->type = type;
+            e->core = xPortGetCoreID();
+        } else {
+            b->dropped++;
+        }
+    }
+
+    if(isr) portEXIT_CRITICAL_ISR(&trace_mux);
+    else portEXIT_CRITICAL(&trace_mux);
+}
+
+/**
+ * Drop-in replacement for disp_driver_flush() that timestamps the flush start
+ */
+void coex_profiler_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map)
+{
+    coex_profiler_record(COEX_EVT_FLUSH_START, 0, lv_area_get_size(area));
+    disp_driver_flush(drv, area, color_map);
+}
+
+/**
+ * One iteration of the GUI loop (vTaskDelay(1) + lv_task_handler()) with
+ * the wake-up latency and the handler run time recorded.
+ */
+void coex_profiler_gui_step(void)
+{
+    int64_t expected = esp_timer_get_time() + portTICK_PERIOD_MS * 1000;
+    vTaskDelay(1);
+
+    int64_t woke = esp_timer_get_time();
+    int64_t late = woke - expected;
+    coex_profiler_record(COEX_EVT_GUI_WAKE, 0, late > 0 ? (uint32_t) late : 0);
+
+    lv_task_handler();
+    coex_profiler_record(COEX_EVT_GUI_RUN, 0, (uint32_t)(esp_timer_get_time() - woke));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void IRAM_ATTR flush_done(void)
+{
+    coex_profiler_record(COEX_EVT_FLUSH_END, 0, 0);
+    if(chained_flush_done) chained_flush_done();
+}
+
+static void wifi_event_cb(void * arg, esp_event_base_t base, int32_t id, void * data)
+{
+    uint16_t tag = ((base == IP_EVENT ? 1 : 0) << 8) | (id & 0xFF);
+    coex_profiler_record(COEX_EVT_WIFI, tag, 0);
+}
+
+#if CONFIG_COEX_PROFILER_SNIFF_RX
+static void wifi_rx_cb(void * buf, wifi_promiscuous_pkt_type_t type)
+{
+    const wifi_promiscuous_pkt_t * pkt = buf;
+    coex_profiler_record(COEX_EVT_WIFI_RX, type, pkt->rx_ctrl.sig_len);
+}
+#endif
+
+static void report_task(void * arg)
+{
+    TickType_t last = xTaskGetTickCount();
+
+    for(;;) {
+        vTaskDelayUntil(&last, pdMS_TO_TICKS(REPORT_PERIOD));
+
+        coex_buf_t * done = swap_buffers();
+        analyse(done);
+        done->count = 0;
+        done->dropped = 0;
+    }
+}
+
+/* Make the other buffer active and return the one that was filled */
+static coex_buf_t * swap_buffers(void)
+{
+    portENTER_CRITICAL(&trace_mux);
+    coex_buf_t * done = active;
+    active = (done == &bufs[0]) ? &bufs[1] : &bufs[0];
+    portEXIT_CRITICAL(&trace_mux);
+
+    return done;
+}
+
+static void analyse(const coex_buf_t * b)
+{
+    if(b->count == 0) return;
+
+    coex_summary_t sum;
+    memset(&sum, 0, sizeof(sum));
+
+    /*Times are made relative to the first entry so a wrap of the 32 bit
+     *microsecond counter inside the period does not break the ordering*/
+    uint32_t base = b->entries[0].t_us;
+    wifi_ts_cnt = 0;
+    for(uint32_t i = 0; i < b->count; i++) {
+        const coex_entry_t * e = &b->entries[i];
+        if(e->type == COEX_EVT_WIFI) sum.wifi_events++;
+        else if(e->type == COEX_EVT_WIFI_RX) sum.wifi_rx++;
+        else continue;
+        wifi_ts[wifi_ts_cnt++] = e->t_us - base;
+    }
+
+    /*First pass: statistics per class, second pass: excess over the quiet mean*/
+    walk_samples(b, visit_stat, &sum);
+    for(int m = 0; m < METRIC_NUM; m++) {
+        const coex_stat_t * q = &sum.stat[m][0];
+        sum.mean_quiet[m] = q->n ? (uint32_t)(q->sum / q->n) : 0;
+    }
+    walk_samples(b, visit_excess, &sum);
+
+    ESP_LOGI(TAG, "--- %u entries (%u dropped), %u Wi-Fi events, %u rx frames",
+             b->count, b->dropped, sum.wifi_events, sum.wifi_rx);
+    for(int m = 0; m < METRIC_NUM; m++) {
+        print_metric(metric_names[m], &sum, m);
+    }
+
+    if(beacon_period_us) {
+        uint64_t total = 0;
+        for(int i = 0; i < PHASE_BINS; i++) total += sum.phase_excess[i];
+        if(total) {
+            char line[8 * PHASE_BINS + 1];
+            int pos = 0;
+            for(int i = 0; i < PHASE_BINS; i++) {
+                pos += snprintf(&line[pos], sizeof(line) - pos, " %3u%%",
+                                (unsigned)(sum.phase_excess[i] * 100 / total));
+            }
+            ESP_LOGI(TAG, "flush excess by beacon phase (1/%d of %u us):%s",
+                     PHASE_BINS, beacon_period_us, line);
+        }
+    }
+
+    print_core_load();
+
+#if CONFIG_COEX_PROFILER_DUMP_TRACE
+    for(uint32_t i = 0; i < b->count; i++) {
+        const coex_entry_t * e = &b->entries[i];
+        printf("coex,%u,%u,%u,%u,%u\n", e->t_us, e->core, e->type, e->arg, e->val);
+    }
+#endif
+}
+
+/* Turn the raw trace into samples and hand each one to `cb` */
+static void walk_samples(const coex_buf_t * b, coex_visit_cb_t cb, coex_summary_t * sum)
+{
+    uint32_t base = b->entries[0].t_us;
+    bool flush_open = false;
+    coex_sample_t flush = {.metric = METRIC_FLUSH};
+
+    for(uint32_t i = 0; i < b->count; i++) {
+        const coex_entry_t * e = &b->entries[i];
+        uint32_t t = e->t_us - base;
+        coex_sample_t s;
+
+        switch(e->type) {
+            case COEX_EVT_FLUSH_START:
+                flush.from = t;
+                flush.t_abs = e->t_us;
+                flush_open = true;
+                break;
+            case COEX_EVT_FLUSH_END:
+                if(!flush_open) break;
+                flush.to = t;
+                flush.value = t - flush.from;
+                flush_open = false;
+                cb(&flush, near_wifi(flush.from, flush.to), sum);
+                break;
+            case COEX_EVT_GUI_WAKE:
+            case COEX_EVT_GUI_RUN:
+                s.metric = e->type == COEX_EVT_GUI_WAKE ? METRIC_WAKE : METRIC_RENDER;
+                s.value = e->val;
+                s.to = t;
+                s.from = t > e->val ? t - e->val : 0;
+                s.t_abs = e->t_us - e->val;
+                cb(&s, near_wifi(s.from, s.to), sum);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/* Is there a Wi-Fi timestamp within the attribution window of [from, to]? */
+static bool near_wifi(uint32_t from, uint32_t to)
+{
+    from = from > WIFI_WINDOW_US ? from - WIFI_WINDOW_US : 0;
+    to += WIFI_WINDOW_US;
+
+    /*First Wi-Fi timestamp >= from*/
+    uint32_t lo = 0;
+    uint32_t hi = wifi_ts_cnt;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if(wifi_ts[mid] < from) lo = mid + 1;
+        else hi = mid;
+    }
+
+    return lo < wifi_ts_cnt && wifi_ts[lo] <= to;
+}
+
+static void visit_stat(const coex_sample_t * s, bool near, coex_summary_t * sum)
+{
+    coex_stat_t * st = &sum->stat[s->metric][near];
+    st->n++;
+    st->sum += s->value;
+    st->sum_sq += (uint64_t) s->value * s->value;
+    if(s->value > st->max) st->max = s->value;
+}
+
+static void visit_excess(const coex_sample_t * s, bool near, coex_summary_t * sum)
+{
+    uint32_t mean = sum->mean_quiet[s->metric];
+    if(s->value <= mean) return;
+
+    uint32_t excess = s->value - mean;
+    sum->excess[s->metric][near] += excess;
+
+    if(s->metric == METRIC_FLUSH && beacon_period_us) {
+        uint32_t bin = (s->t_abs % beacon_period_us) * PHASE_BINS / beacon_period_us;
+        sum->phase_excess[bin] += excess;
+    }
+}
+
+static void print_metric(const char * name, const coex_summary_t * sum, coex_metric_t m)
+{
+    uint32_t avg[2];
+    uint32_t sd[2];
+
+    for(int near = 0; near < 2; near++) {
+        const coex_stat_t * st = &sum->stat[m][near];
+        avg[near] = st->n ? (uint32_t)(st->sum / st->n) : 0;
+        float var = st->n ? (float) st->sum_sq / st->n - (float) avg[near] * avg[near] : 0;
+        sd[near] = var > 0 ? (uint32_t) sqrtf(var) : 0;
+    }
+
+    uint64_t total = sum->excess[m][0] + sum->excess[m][1];
+    unsigned share = total ? (unsigned)(sum->excess[m][1] * 100 / total) : 0;
+
+    ESP_LOGI(TAG, "%-8s quiet n=%u avg=%u sd=%u max=%u | near Wi-Fi n=%u avg=%u sd=%u max=%u | "
+             "jitter from Wi-Fi %u%%", name,
+             sum->stat[m][0].n, avg[0], sd[0], sum->stat[m][0].max,
+             sum->stat[m][1].n, avg[1], sd[1], sum->stat[m][1].max,
+             share);
+}
+
+static void print_core_load(void)
+{
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    static uint32_t last_idle[portNUM_PROCESSORS];
+    static uint32_t last_total;
+
+    UBaseType_t n = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t * st = malloc(n * sizeof(TaskStatus_t));
+    if(!st) return;
+
+    uint32_t total;
+    n = uxTaskGetSystemState(st, n, &total);
+
+    uint32_t dt = total - last_total;
+    for(int cpu = 0; cpu < portNUM_PROCESSORS; cpu++) {
+        TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(cpu);
+        for(UBaseType_t i = 0; i < n; i++) {
+            if(st[i].xHandle != idle) continue;
+            uint32_t di = st[i].ulRunTimeCounter - last_idle[cpu];
+            last_idle[cpu] = st[i].ulRunTimeCounter;
+            if(dt && last_total) {
+                ESP_LOGI(TAG, "cpu%d load %u%%", cpu, di < dt ? (unsigned)(100 - (uint64_t) di * 100 / dt) : 0);
+            }
+            break;
+        }
+    }
+    last_total = total;
+    free(st);
+#endif
+}
+
+#endif /*COEX_PROFILER_ENABLED*/
@@ -0,0 +1,60 @@
+/**
+ * @file coex_profiler.h
+ *
+ * Wi-Fi / display coexistence profiler.
+ *
+ * Collects Wi-Fi events, SPI flush start/end, GUI task wake-up latency and
+ * per-core load into one time-ordered trace and periodically prints a summary
+ * of how much of the flush and render jitter coincides with Wi-Fi activity.
+ */
+
+#ifndef COEX_PROFILER_H
+#define COEX_PROFILER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define COEX_PROFILER_ENABLED CONFIG_COEX_PROFILER
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum {
+    COEX_EVT_WIFI = 0,      /* esp_event from WIFI_EVENT / IP_EVENT, arg = base << 8 | id */
+    COEX_EVT_WIFI_RX,       /* frame seen by the promiscuous callback, arg = type, val = length */
+    COEX_EVT_FLUSH_START,   /* flush_cb entered, val = pixel count */
+    COEX_EVT_FLUSH_END,     /* color transaction finished (SPI ISR) */
+    COEX_EVT_GUI_WAKE,      /* GUI loop woke up, val = latency past the expected wake time [us] */
+    COEX_EVT_GUI_RUN,       /* lv_task_handler() finished, val = its run time [us] */
+} coex_evt_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void coex_profiler_init(void);
+void IRAM_ATTR coex_profiler_record(coex_evt_t type, uint16_t arg, uint32_t val);
+void coex_profiler_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_map);
+void coex_profiler_gui_step(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*COEX_PROFILER_H*/
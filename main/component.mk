@@ -1,6 +1,6 @@
-#
-# "main" pseudo-component makefile.
-#
-# (Uses default behaviour of compiling all source files in directory, adding 'include' to include path.)
-
-CFLAGS+= -DLV_CONF_INCLUDE_SIMPLE
+#
+# "main" pseudo-component makefile.
+#
+# (Uses default behaviour of compiling all source files in directory, adding 'include' to include path.)
+
+CFLAGS+= -DLV_CONF_INCLUDE_SIMPLE
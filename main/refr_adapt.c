@@ -0,0 +1,147 @@
+/**
+ * @file refr_adapt.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "refr_adapt.h"
+
+#if REFR_ADAPT_ENABLED
+
+#include "freertos/FreeRTOS.h"
+#include "esp_log.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "refr_adapt"
+
+#define MIN_PERIOD      CONFIG_REFR_ADAPT_MIN_PERIOD_MS
+#define MAX_PERIOD      CONFIG_REFR_ADAPT_MAX_PERIOD_MS
+#define BUDGET_PCT      CONFIG_REFR_ADAPT_BUDGET_PCT
+#define SHRINK_FRAMES   CONFIG_REFR_ADAPT_SHRINK_FRAMES
+
+#define COST_FRAC       4       /* fractional bits of the averaged cost */
+#define EWMA_SHIFT      3       /* each frame weighs 1/8 in the average */
+
+/* The GUI loop runs lv_task_handler() once per tick, so any period that is
+ * not a whole number of ticks alternates between two frame intervals and
+ * animations judder. */
+#define QUANTUM         portTICK_PERIOD_MS
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t quantize(uint32_t p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_task_t * refr_task;
+static uint32_t period;
+static uint32_t cost_avg;       /* [ms << COST_FRAC] */
+static uint32_t headroom_cnt;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Take over the period of the display's refresh task.
+ * Set refr_adapt_monitor() as the driver's monitor_cb as well.
+ * @param disp display returned by lv_disp_drv_register()
+ */
+void refr_adapt_init(lv_disp_t * disp)
+{
+    assert(disp != NULL && disp->refr_task != NULL);
+
+    refr_task = disp->refr_task;
+    period = quantize(LV_DISP_DEF_REFR_PERIOD);
+    cost_avg = 0;
+    headroom_cnt = 0;
+    lv_task_set_period(refr_task, period);
+
+    ESP_LOGI(TAG, "refresh period %u ms (%u..%u ms, %u%% budget)",
+             period, quantize(MIN_PERIOD), quantize(MAX_PERIOD), BUDGET_PCT);
+}
+
+/**
+ * monitor_cb of the display driver, called after every refreshed frame.
+ * @param drv the display driver
+ * @param time time spent rendering and flushing the frame [ms]
+ * @param px number of refreshed pixels
+ */
+void refr_adapt_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    (void)drv;
+    (void)px;
+
+    if(refr_task == NULL) return;
+
+    int32_t sample = (int32_t)(time << COST_FRAC);
+    if(cost_avg == 0) cost_avg = sample;
+    else cost_avg += (sample - (int32_t)cost_avg) / (1 << EWMA_SHIFT);
+
+    /* Smallest period that keeps the averaged cost within the budget */
+    uint32_t budget = BUDGET_PCT << COST_FRAC;
+    uint32_t target = quantize((cost_avg * 100 + budget - 1) / budget);
+
+    uint32_t new_period = period;
+    if(target > period) {
+        /* Under load: back off at once */
+        new_period = target;
+        headroom_cnt = 0;
+    } else if(target < period) {
+        /* Headroom: speed up one tick at a time once it persisted */
+        if(++headroom_cnt >= SHRINK_FRAMES) {
+            new_period = period - QUANTUM;
+            headroom_cnt = 0;
+        }
+    } else {
+        headroom_cnt = 0;
+    }
+
+    if(new_period != period) {
+        period = new_period;
+        lv_task_set_period(refr_task, period);
+        ESP_LOGD(TAG, "frame cost %u.%02u ms, refresh period %u ms",
+                 cost_avg >> COST_FRAC, ((cost_avg & ((1 << COST_FRAC) - 1)) * 100) >> COST_FRAC, period);
+    }
+}
+
+/**
+ * @return the current refresh period [ms]
+ */
+uint32_t refr_adapt_get_period(void)
+{
+    return period;
+}
+
+/**
+ * @return the averaged frame cost [ms]
+ */
+uint32_t refr_adapt_get_cost(void)
+{
+    return cost_avg >> COST_FRAC;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Round up to whole ticks and clamp to the configured range */
+static uint32_t quantize(uint32_t p)
+{
+    uint32_t min = (MIN_PERIOD + QUANTUM - 1) / QUANTUM * QUANTUM;
+    uint32_t max = MAX_PERIOD / QUANTUM * QUANTUM;
+    if(max < min) max = min;
+
+    p = (p + QUANTUM - 1) / QUANTUM * QUANTUM;
+    if(p < min) return min;
+    if(p > max) return max;
+    return p;
+}
+
+#endif /*REFR_ADAPT_ENABLED*/
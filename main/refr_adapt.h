@@ -0,0 +1,43 @@
+/**
+ * @file refr_adapt.h
+ *
+ * Adaptive display refresh period. The period of the LVGL refresh task
+ * follows the measured frame cost instead of the fixed LV_DISP_DEF_REFR_PERIOD.
+ */
+
+#ifndef REFR_ADAPT_H
+#define REFR_ADAPT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define REFR_ADAPT_ENABLED CONFIG_REFR_ADAPT
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void refr_adapt_init(lv_disp_t * disp);
+void refr_adapt_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+uint32_t refr_adapt_get_period(void);
+uint32_t refr_adapt_get_cost(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*REFR_ADAPT_H*/
@@ -0,0 +1,169 @@
+/**
+ * @file task_affinity.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "task_affinity.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+
+#include "touch_driver.h"
+#include "websocket_server.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "task_affinity"
+
+#define SPI_INIT_STACK_SIZE 4096
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    void (*init)(void);
+    SemaphoreHandle_t done;
+} spi_init_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void spi_init_task(void * arg);
+static int core_of(BaseType_t affinity);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static TaskHandle_t gui_handle;
+static int spi_isr_core = -1;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Hand the touch placement to the driver and start the GUI task
+ * on its configured core.
+ * @param gui_task the task running lv_init(), the drivers and lv_task_handler()
+ */
+void task_affinity_start_gui(TaskFunction_t gui_task)
+{
+    touch_driver_set_task_placement(AFFINITY_CORE(TOUCH_TASK_CORE), TOUCH_TASK_PRIORITY);
+
+    BaseType_t ret = xTaskCreatePinnedToCore(gui_task, "gui", GUI_TASK_STACK_SIZE, NULL,
+            GUI_TASK_PRIORITY, &gui_handle, GUI_TASK_CORE);
+    assert(ret == pdPASS);
+}
+
+/**
+ * Run the SPI bus initialization on DISP_SPI_ISR_CORE. The SPI master
+ * allocates its interrupt on the calling core, so this decides where the
+ * transaction done callbacks run. Blocks until init() returned.
+ * @param init function calling spi_bus_initialize() (and any device setup)
+ */
+void task_affinity_run_spi_init(void (*init)(void))
+{
+    if(xTaskGetAffinity(NULL) == DISP_SPI_ISR_CORE) {
+        init();
+        spi_isr_core = xPortGetCoreID();
+        return;
+    }
+
+    spi_init_ctx_t ctx = {
+        .init = init,
+        .done = xSemaphoreCreateBinary(),
+    };
+    assert(ctx.done != NULL);
+
+    BaseType_t ret = xTaskCreatePinnedToCore(spi_init_task, "spi_init", SPI_INIT_STACK_SIZE, &ctx,
+            uxTaskPriorityGet(NULL), NULL, DISP_SPI_ISR_CORE);
+    assert(ret == pdPASS);
+
+    xSemaphoreTake(ctx.done, portMAX_DELAY);
+    vSemaphoreDelete(ctx.done);
+}
+
+/**
+ * Start the websocket server with the placement from the "Task placement" menu.
+ * @return see ws_server_start()
+ */
+int task_affinity_start_ws_server(void)
+{
+    return ws_server_start_pinned(AFFINITY_CORE(WS_SERVER_TASK_CORE), WS_SERVER_TASK_PRIORITY);
+}
+
+/**
+ * Log where the tasks actually ended up and warn about placements
+ * that defeat the purpose (GUI next to Wi-Fi, mismatching requests).
+ */
+void task_affinity_report(void)
+{
+    if(gui_handle) {
+        ESP_LOGI(TAG, "gui:       core %d prio %u", core_of(xTaskGetAffinity(gui_handle)),
+                 uxTaskPriorityGet(gui_handle));
+        if(core_of(xTaskGetAffinity(gui_handle)) != GUI_TASK_CORE) {
+            ESP_LOGW(TAG, "gui task is not on the requested core %d", GUI_TASK_CORE);
+        }
+    } else {
+        ESP_LOGW(TAG, "gui:       not started through task_affinity_start_gui()");
+    }
+
+    if(spi_isr_core >= 0) {
+        ESP_LOGI(TAG, "disp spi:  isr core %d", spi_isr_core);
+    } else {
+        ESP_LOGW(TAG, "disp spi:  bus not initialized through task_affinity_run_spi_init()");
+    }
+
+    TaskHandle_t touch = touch_driver_get_task();
+    if(touch) {
+        ESP_LOGI(TAG, "touch:     core %d prio %u", core_of(xTaskGetAffinity(touch)),
+                 uxTaskPriorityGet(touch));
+    } else {
+        ESP_LOGI(TAG, "touch:     polled from the gui task");
+    }
+
+    TaskHandle_t ws = ws_server_get_task();
+    if(ws) {
+        ESP_LOGI(TAG, "ws_server: core %d prio %u", core_of(xTaskGetAffinity(ws)),
+                 uxTaskPriorityGet(ws));
+    } else {
+        ESP_LOGI(TAG, "ws_server: not running");
+    }
+
+    ESP_LOGI(TAG, "wifi:      core %d", WIFI_TASK_CORE);
+#ifdef CONFIG_LWIP_TCPIP_TASK_AFFINITY
+    ESP_LOGI(TAG, "lwip:      core %d", core_of(CONFIG_LWIP_TCPIP_TASK_AFFINITY));
+#endif
+
+    if(GUI_TASK_CORE == WIFI_TASK_CORE) {
+        ESP_LOGW(TAG, "gui task shares core %d with the Wi-Fi task, expect render stalls under traffic",
+                 WIFI_TASK_CORE);
+    }
+    if(spi_isr_core == WIFI_TASK_CORE) {
+        ESP_LOGW(TAG, "display SPI interrupt shares core %d with the Wi-Fi task", WIFI_TASK_CORE);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void spi_init_task(void * arg)
+{
+    spi_init_ctx_t * ctx = arg;
+
+    ctx->init();
+    spi_isr_core = xPortGetCoreID();
+
+    xSemaphoreGive(ctx->done);
+    vTaskDelete(NULL);
+}
+
+/* -1 for tasks without affinity */
+static int core_of(BaseType_t affinity)
+{
+    return affinity == tskNO_AFFINITY ? -1 : (int)affinity;
+}
@@ -0,0 +1,59 @@
+/**
+ * @file task_affinity.h
+ *
+ * Core and priority placement of the GUI, display SPI, touch and websocket
+ * tasks, taken from the "Task placement" menu.
+ */
+
+#ifndef TASK_AFFINITY_H
+#define TASK_AFFINITY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define GUI_TASK_CORE           CONFIG_GUI_TASK_CORE
+#define GUI_TASK_PRIORITY       CONFIG_GUI_TASK_PRIORITY
+#define GUI_TASK_STACK_SIZE     CONFIG_GUI_TASK_STACK_SIZE
+#define DISP_SPI_ISR_CORE       CONFIG_DISP_SPI_ISR_CORE
+#define TOUCH_TASK_CORE         CONFIG_TOUCH_TASK_CORE
+#define TOUCH_TASK_PRIORITY     CONFIG_TOUCH_TASK_PRIORITY
+#define WS_SERVER_TASK_CORE     CONFIG_WS_SERVER_TASK_CORE
+#define WS_SERVER_TASK_PRIORITY CONFIG_WS_SERVER_TASK_PRIORITY
+
+#if CONFIG_ESP32_WIFI_TASK_PINNED_TO_CORE_1
+#define WIFI_TASK_CORE          1
+#else
+#define WIFI_TASK_CORE          0
+#endif
+
+/* Kconfig uses -1 for "no affinity" */
+#define AFFINITY_CORE(c)        ((c) < 0 ? tskNO_AFFINITY : (c))
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void task_affinity_start_gui(TaskFunction_t gui_task);
+void task_affinity_run_spi_init(void (*init)(void));
+int task_affinity_start_ws_server(void);
+void task_affinity_report(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TASK_AFFINITY_H*/
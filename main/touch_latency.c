@@ -0,0 +1,306 @@
+/**
+ * @file touch_latency.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_latency.h"
+
+#if TOUCH_LATENCY_ENABLED
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+
+#include "disp_spi.h"
+#include "touch_driver.h"
+#include "tp_spi.h"
+#include "touch_trace.h"
+#include "touch_predict.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "touch_latency"
+
+#define REPORT_PERIOD   CONFIG_TOUCH_LATENCY_REPORT_PERIOD_MS
+
+#define BIN_NUM         (sizeof(bin_edges) / sizeof(bin_edges[0]) + 1)
+
+/* Synthetic stream: one press every SYNTH_CYCLE ms, dragged for SYNTH_DRAG ms */
+#define SYNTH_CYCLE     1000
+#define SYNTH_DRAG      300
+#define SYNTH_SPEED     10      /* drag speed [ms per pixel] */
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t n;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t no_redraw;     /* samples that caused no invalidation */
+    uint32_t bins[16];
+} latency_stat_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void IRAM_ATTR flush_done(void);
+static void report_task(void * arg);
+static uint32_t percentile(const latency_stat_t * s, uint32_t pct);
+#if TOUCH_LATENCY_SYNTHETIC
+static bool synthetic_read(lv_indev_data_t * data);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/* Upper bin edges [us], the last bin collects everything above */
+static const uint32_t bin_edges[] = {
+    4000, 8000, 12000, 16000, 24000, 32000, 48000, 64000, 96000, 128000, 192000, 256000
+};
+
+static portMUX_TYPE lat_mux = portMUX_INITIALIZER_UNLOCKED;
+static latency_stat_t stat;
+static disp_spi_flush_done_cb_t chained_flush_done;
+
+/* One measurement in flight: sample -> (invalidation) -> flush done */
+static uint32_t t_input;        /* sample acquired, waiting for an invalidation */
+static uint32_t t_frame;        /* invalidation seen, waiting for the flush */
+static uint32_t frame_seq;      /* flushes started before the invalidation */
+static uint32_t flushes_done;
+static bool input_pending;
+static bool frame_pending;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Hook the flush done callback of the display SPI and start the report task.
+ * Set touch_latency_read() as read_cb and touch_latency_rounder() as
+ * rounder_cb as well.
+ */
+void touch_latency_init(void)
+{
+    _Static_assert(sizeof(bin_edges) / sizeof(bin_edges[0]) < sizeof(stat.bins) / sizeof(stat.bins[0]),
+                   "too many latency bins");
+
+    memset(&stat, 0, sizeof(stat));
+    stat.min = UINT32_MAX;
+    /*No flush is in flight before the first lv_task_handler()*/
+    flushes_done = disp_spi_get_flush_count();
+    chained_flush_done = disp_spi_set_flush_done_cb(flush_done);
+
+    xTaskCreate(report_task, "touch_latency", 3072, NULL, 1, NULL);
+
+#if TOUCH_LATENCY_SYNTHETIC
+    ESP_LOGI(TAG, "Measuring a synthetic touch stream, report every %d ms", REPORT_PERIOD);
+#else
+    ESP_LOGI(TAG, "Measuring, report every %d ms", REPORT_PERIOD);
+#endif
+}
+
+/**
+ * read_cb of the pointer input device. Reads the touch driver (or the
+ * synthetic stream) and keeps the acquisition time of every sample LVGL
+ * will react to.
+ * @param drv the input device driver
+ * @param data store the sample here
+ * @return true if more samples are waiting
+ */
+bool touch_latency_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
+{
+    static lv_indev_state_t last_state = LV_INDEV_STATE_REL;
+    static lv_point_t last_point;
+
+#if TOUCH_LATENCY_SYNTHETIC
+    (void)drv;
+    bool more = synthetic_read(data);
+    uint32_t t = (uint32_t) esp_timer_get_time();
+#elif TOUCH_TRACE_ENABLED
+    bool more = touch_trace_read(drv, data);
+    uint32_t t = (uint32_t) touch_trace_get_sample_time();
+#else
+    /*Queued samples were acquired before this read*/
+    bool more = touch_driver_read(drv, data);
+    uint32_t t = (uint32_t) touch_driver_get_sample_time();
+#endif
+
+    bool changed = data->state != last_state ||
+                   (data->state == LV_INDEV_STATE_PR &&
+                    (data->point.x != last_point.x || data->point.y != last_point.y));
+    last_state = data->state;
+    last_point = data->point;
+    if(!changed) return more;
+
+    portENTER_CRITICAL(&lat_mux);
+    /* The previous sample was processed by LVGL without redrawing anything */
+    if(input_pending) stat.no_redraw++;
+
+    input_pending = !frame_pending;
+    t_input = t;
+    portEXIT_CRITICAL(&lat_mux);
+
+    return more;
+}
+
+/**
+ * rounder_cb of the display driver. LVGL calls it for every invalidated
+ * area, the first one after a touch sample arms the measurement.
+ * Rounds nothing.
+ * @param drv the display driver
+ * @param area the invalidated area
+ */
+void touch_latency_rounder(lv_disp_drv_t * drv, lv_area_t * area)
+{
+    (void)drv;
+    (void)area;
+
+    portENTER_CRITICAL(&lat_mux);
+    if(input_pending) {
+        t_frame = t_input;
+        frame_seq = disp_spi_get_flush_count();
+        frame_pending = true;
+        input_pending = false;
+    }
+    portEXIT_CRITICAL(&lat_mux);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* The first flush started after the invalidation closes the measurement.
+ * With two draw buffers the one in flight at the invalidation can still
+ * belong to the previous frame. */
+static void IRAM_ATTR flush_done(void)
+{
+    uint32_t now = (uint32_t) esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&lat_mux);
+    flushes_done++;
+    if(frame_pending && (int32_t)(flushes_done - frame_seq) > 0) {
+        uint32_t lat = now - t_frame;
+        uint32_t b = 0;
+        while(b < BIN_NUM - 1 && lat > bin_edges[b]) b++;
+
+        stat.bins[b]++;
+        stat.n++;
+        stat.sum += lat;
+        if(lat < stat.min) stat.min = lat;
+        if(lat > stat.max) stat.max = lat;
+        frame_pending = false;
+    }
+    portEXIT_CRITICAL_ISR(&lat_mux);
+
+    if(chained_flush_done) chained_flush_done();
+}
+
+static void report_task(void * arg)
+{
+    latency_stat_t s;
+    tp_spi_stats_t bus;
+    char line[16 * 8];
+
+    while(1) {
+        vTaskDelay(REPORT_PERIOD / portTICK_PERIOD_MS);
+
+        portENTER_CRITICAL(&lat_mux);
+        s = stat;
+        memset(&stat, 0, sizeof(stat));
+        stat.min = UINT32_MAX;
+        portEXIT_CRITICAL(&lat_mux);
+
+        /*Only counted for controllers on SPI*/
+        tp_spi_get_stats(&bus, true);
+        if(bus.count) {
+            ESP_LOGI(TAG, "touch SPI wait: %u transactions, mean %u us, max %u us",
+                     bus.count, bus.total_us / bus.count, bus.max_us);
+        }
+
+        if(s.n == 0) {
+            ESP_LOGI(TAG, "no measurements (%u samples without redraw)", s.no_redraw);
+            continue;
+        }
+
+        ESP_LOGI(TAG, "n %u, min %u.%01u, mean %u.%01u, p50 <%u, p90 <%u, p99 <%u, max %u.%01u ms, %u without redraw",
+                 s.n, s.min / 1000, s.min % 1000 / 100,
+                 (uint32_t)(s.sum / s.n) / 1000, (uint32_t)(s.sum / s.n) % 1000 / 100,
+                 percentile(&s, 50), percentile(&s, 90), percentile(&s, 99),
+                 s.max / 1000, s.max % 1000 / 100, s.no_redraw);
+
+#if TOUCH_PREDICT_ENABLED
+        /* Predict as far ahead as the pipeline lags */
+        touch_predict_set_horizon((uint32_t)(s.sum / s.n + 500) / 1000);
+#endif
+
+        /* Bin counts, the header gives the upper edge [ms] */
+        size_t len = 0;
+        for(uint32_t b = 0; b < BIN_NUM - 1; b++) {
+            len += snprintf(line + len, sizeof(line) - len, "%6u", bin_edges[b] / 1000);
+        }
+        snprintf(line + len, sizeof(line) - len, "   inf");
+        ESP_LOGI(TAG, "<=%s", line);
+
+        len = 0;
+        for(uint32_t b = 0; b < BIN_NUM; b++) {
+            len += snprintf(line + len, sizeof(line) - len, "%6u", s.bins[b]);
+        }
+        ESP_LOGI(TAG, "  %s", line);
+    }
+}
+
+/* Upper edge [ms] of the bin holding the given percentile */
+static uint32_t percentile(const latency_stat_t * s, uint32_t pct)
+{
+    uint32_t target = (s->n * pct + 99) / 100;
+    uint32_t acc = 0;
+
+    for(uint32_t b = 0; b < BIN_NUM - 1; b++) {
+        acc += s->bins[b];
+        if(acc >= target) return bin_edges[b] / 1000;
+    }
+    return (s->max + 999) / 1000;
+}
+
+#if TOUCH_LATENCY_SYNTHETIC
+/* A fixed script of presses on a few points, each dragged to the right.
+ * Driven by the LVGL tick only, so every build sees the same stream. */
+static bool synthetic_read(lv_indev_data_t * data)
+{
+    static const uint8_t pos[][2] = {   /* [% of the resolution] */
+        {25, 25}, {75, 25}, {50, 50}, {25, 75}, {75, 75}
+    };
+
+    uint32_t t = lv_tick_get();
+    uint32_t phase = t % SYNTH_CYCLE;
+    uint32_t i = (t / SYNTH_CYCLE) % (sizeof(pos) / sizeof(pos[0]));
+
+    data->point.x = LV_HOR_RES * pos[i][0] / 100;
+    data->point.y = LV_VER_RES * pos[i][1] / 100;
+    if(phase < SYNTH_DRAG) {
+        data->point.x += phase / SYNTH_SPEED;
+        data->state = LV_INDEV_STATE_PR;
+    } else {
+        data->point.x += SYNTH_DRAG / SYNTH_SPEED;
+        data->state = LV_INDEV_STATE_REL;
+    }
+    if(data->point.x >= LV_HOR_RES) data->point.x = LV_HOR_RES - 1;
+
+    return false;
+}
+#endif
+
+#endif /*TOUCH_LATENCY_ENABLED*/
@@ -0,0 +1,46 @@
+/**
+ * @file touch_latency.h
+ *
+ * Touch-to-photon latency measurement. A touch sample is timestamped when
+ * it is acquired, the first invalidation it causes arms the measurement and
+ * the first flush started after that closes it in the SPI ISR. The
+ * latencies are reported as a histogram.
+ */
+
+#ifndef TOUCH_LATENCY_H
+#define TOUCH_LATENCY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_LATENCY_ENABLED   CONFIG_TOUCH_LATENCY
+#define TOUCH_LATENCY_SYNTHETIC CONFIG_TOUCH_LATENCY_SYNTHETIC
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void touch_latency_init(void);
+bool touch_latency_read(lv_indev_drv_t * drv, lv_indev_data_t * data);
+void touch_latency_rounder(lv_disp_drv_t * drv, lv_area_t * area);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TOUCH_LATENCY_H*/
@@ -0,0 +1,339 @@
+/**
+ * @file touch_trace.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_trace.h"
+
+#if TOUCH_TRACE_ENABLED
+
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs.h"
+
+#include "touch_driver.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TAG "touch_trace"
+
+#define NVS_NAMESPACE   "touch_trace"
+#define NVS_KEY         "trace"
+#define BLOB_MAGIC      0x54545201      /*"TTR", version 1*/
+
+#if TOUCH_TRACE_RECORD
+#define MAX_EVENTS      CONFIG_TOUCH_TRACE_MAX_EVENTS
+#define RECORD_TIME     CONFIG_TOUCH_TRACE_RECORD_MS
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t magic;
+    lv_coord_t hor_res;         /*Replaying on another resolution makes no sense*/
+    lv_coord_t ver_res;
+    uint32_t count;
+    touch_trace_event_t events[];
+} trace_blob_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if TOUCH_TRACE_RECORD
+static void record(const lv_indev_data_t * data);
+static bool append(uint32_t dt, const lv_indev_data_t * data);
+#else
+static esp_err_t load_nvs(void);
+static bool replay(lv_indev_data_t * data);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static trace_blob_t * trace;
+static int64_t sample_time;
+
+#if TOUCH_TRACE_RECORD
+static bool recording;
+static uint32_t rec_start;
+static uint32_t rec_last;
+static lv_indev_data_t rec_prev;
+#else
+static const trace_blob_t * replay_trace;
+static bool replay_running;
+static uint32_t replay_start;
+static uint32_t replay_due;     /*Time of the next event since replay_start [ms]*/
+static uint32_t replay_idx;
+static uint32_t replay_pass;
+static lv_indev_data_t replay_cur;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Allocate the recording buffer or load the trace to replay from NVS.
+ * nvs_flash_init() must have been called.
+ */
+void touch_trace_init(void)
+{
+#if TOUCH_TRACE_RECORD
+    trace = malloc(sizeof(trace_blob_t) + MAX_EVENTS * sizeof(touch_trace_event_t));
+    assert(trace != NULL);
+
+    trace->magic = BLOB_MAGIC;
+    trace->hor_res = LV_HOR_RES;
+    trace->ver_res = LV_VER_RES;
+    trace->count = 0;
+    rec_prev.state = LV_INDEV_STATE_REL;
+    recording = true;
+
+    ESP_LOGI(TAG, "Recording up to %d samples for %d ms", MAX_EVENTS, RECORD_TIME);
+#else
+    if(load_nvs() != ESP_OK) {
+        ESP_LOGW(TAG, "No trace to replay, using the touch controller");
+    }
+#endif
+}
+
+/**
+ * read_cb of the pointer input device. Records the samples of
+ * touch_driver_read() or replays the loaded trace instead.
+ * @param drv the input device driver
+ * @param data store the sample here
+ * @return true if more samples are waiting
+ */
+bool touch_trace_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
+{
+#if TOUCH_TRACE_RECORD
+    bool more = touch_driver_read(drv, data);
+    sample_time = touch_driver_get_sample_time();
+    if(recording) record(data);
+    return more;
+#else
+    /*Back to the controller once a single pass is over*/
+    if(replay_trace == NULL || (!replay_running && replay_idx == replay_trace->count)) {
+        bool more = touch_driver_read(drv, data);
+        sample_time = touch_driver_get_sample_time();
+        return more;
+    }
+    sample_time = esp_timer_get_time();
+    return replay(data);
+#endif
+}
+
+/**
+ * Like touch_driver_get_sample_time(), replayed samples are taken when read.
+ * @return esp_timer time [us] of the sample last returned by touch_trace_read()
+ */
+int64_t touch_trace_get_sample_time(void)
+{
+    return sample_time;
+}
+
+/**
+ * Store the recorded samples in NVS. Called automatically when the
+ * recording ends.
+ * @return ESP_ERR_INVALID_STATE if nothing was recorded, otherwise the NVS result
+ */
+esp_err_t touch_trace_save(void)
+{
+    if(trace == NULL || trace->count == 0) return ESP_ERR_INVALID_STATE;
+
+    nvs_handle_t nvs;
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs);
+    if(ret != ESP_OK) return ret;
+
+    size_t size = sizeof(trace_blob_t) + trace->count * sizeof(touch_trace_event_t);
+    ret = nvs_set_blob(nvs, NVS_KEY, trace, size);
+    if(ret == ESP_OK) ret = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    if(ret == ESP_ERR_NVS_NOT_ENOUGH_SPACE || ret == ESP_ERR_NVS_VALUE_TOO_LONG) {
+        ESP_LOGE(TAG, "The %u byte trace does not fit into the nvs partition, "
+                 "record fewer samples or enlarge the partition", (unsigned)size);
+    } else if(ret != ESP_OK) {
+        ESP_LOGE(TAG, "Saving failed: %s", esp_err_to_name(ret));
+    }
+    return ret;
+}
+
+/**
+ * Replay a trace from memory, e.g. one printed by the recorder and embedded
+ * into the firmware or a simulator build. Only available in replay mode.
+ * @param blob the trace as stored by touch_trace_save(), must stay valid
+ * @param len size of the blob in bytes
+ * @return ESP_ERR_INVALID_ARG if the blob is not a trace for this display
+ */
+esp_err_t touch_trace_load(const void * blob, size_t len)
+{
+#if TOUCH_TRACE_RECORD
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    const trace_blob_t * t = blob;
+
+    if(len < sizeof(trace_blob_t) || t->magic != BLOB_MAGIC || t->count == 0 ||
+       len != sizeof(trace_blob_t) + t->count * sizeof(touch_trace_event_t)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if(t->hor_res != LV_HOR_RES || t->ver_res != LV_VER_RES) {
+        ESP_LOGE(TAG, "Trace recorded on a %dx%d display", t->hor_res, t->ver_res);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    replay_trace = t;
+    replay_running = false;
+    replay_idx = 0;
+    replay_pass = 0;
+    replay_cur.state = LV_INDEV_STATE_REL;
+
+    ESP_LOGI(TAG, "Replaying %u samples", t->count);
+    return ESP_OK;
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if TOUCH_TRACE_RECORD
+/* Store the sample if LVGL will react to it: a state change or a move while
+ * pressed. The recording time starts with the first press. */
+static void record(const lv_indev_data_t * data)
+{
+    uint32_t now = lv_tick_get();
+    if(trace->count == 0 && data->state == LV_INDEV_STATE_REL) return;
+    if(trace->count == 0) {
+        rec_start = now;
+        rec_last = now;
+    }
+
+    bool changed = data->state != rec_prev.state ||
+                   (data->state == LV_INDEV_STATE_PR &&
+                    (data->point.x != rec_prev.point.x || data->point.y != rec_prev.point.y));
+
+    bool full = false;
+    if(changed) {
+        full = !append(now - rec_last, data);
+        if(!full) {
+            rec_last = now;
+            rec_prev = *data;
+        }
+    }
+
+    if(full || now - rec_start >= RECORD_TIME) {
+        /*A trace must not end pressed, append() keeps the last slot for this*/
+        if(rec_prev.state == LV_INDEV_STATE_PR) {
+            touch_trace_event_t * e = &trace->events[trace->count++];
+            e->dt = now - rec_last > TOUCH_TRACE_DT_MAX ? TOUCH_TRACE_DT_MAX : now - rec_last;
+            e->x = rec_prev.point.x;
+            e->y = rec_prev.point.y;
+        }
+        recording = false;
+
+        ESP_LOGI(TAG, "Recorded %u samples in %u ms", trace->count, now - rec_start);
+        if(touch_trace_save() == ESP_OK) ESP_LOGI(TAG, "Saved, switch to replay mode to use it");
+#if CONFIG_TOUCH_TRACE_DUMP
+        ESP_LOG_BUFFER_HEX(TAG, trace, sizeof(trace_blob_t) + trace->count * sizeof(touch_trace_event_t));
+#endif
+    }
+}
+
+/* Gaps too long for one event are split by repeating the previous state */
+static bool append(uint32_t dt, const lv_indev_data_t * data)
+{
+    touch_trace_event_t * e;
+
+    while(dt > TOUCH_TRACE_DT_MAX) {
+        if(trace->count >= MAX_EVENTS - 1) return false;
+        e = &trace->events[trace->count++];
+        e->dt = TOUCH_TRACE_DT_MAX | (rec_prev.state == LV_INDEV_STATE_PR ? TOUCH_TRACE_PRESSED : 0);
+        e->x = rec_prev.point.x;
+        e->y = rec_prev.point.y;
+        dt -= TOUCH_TRACE_DT_MAX;
+    }
+
+    if(trace->count >= MAX_EVENTS - 1) return false;
+    e = &trace->events[trace->count++];
+    e->dt = dt | (data->state == LV_INDEV_STATE_PR ? TOUCH_TRACE_PRESSED : 0);
+    e->x = data->point.x;
+    e->y = data->point.y;
+    return true;
+}
+
+#else
+
+static esp_err_t load_nvs(void)
+{
+    nvs_handle_t nvs;
+    size_t len = 0;
+
+    esp_err_t ret = nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs);
+    if(ret != ESP_OK) return ret;
+
+    ret = nvs_get_blob(nvs, NVS_KEY, NULL, &len);
+    if(ret == ESP_OK) {
+        trace = malloc(len);
+        if(trace == NULL) ret = ESP_ERR_NO_MEM;
+    }
+    if(ret == ESP_OK) ret = nvs_get_blob(nvs, NVS_KEY, trace, &len);
+    nvs_close(nvs);
+
+    if(ret == ESP_OK) ret = touch_trace_load(trace, len);
+    if(ret != ESP_OK) {
+        free(trace);
+        trace = NULL;
+    }
+    return ret;
+}
+
+/* Hand out every due event once, LVGL repeats the last state in between */
+static bool replay(lv_indev_data_t * data)
+{
+    const trace_blob_t * t = replay_trace;
+    uint32_t now = lv_tick_get();
+
+    if(!replay_running) {
+        replay_running = true;
+        replay_start = now;
+        replay_due = t->events[0].dt & TOUCH_TRACE_DT_MAX;
+    }
+
+    uint32_t elapsed = now - replay_start;
+    if(replay_idx < t->count && elapsed >= replay_due) {
+        const touch_trace_event_t * e = &t->events[replay_idx++];
+        replay_cur.point.x = e->x;
+        replay_cur.point.y = e->y;
+        replay_cur.state = (e->dt & TOUCH_TRACE_PRESSED) ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        if(replay_idx < t->count) replay_due += t->events[replay_idx].dt & TOUCH_TRACE_DT_MAX;
+    }
+
+    *data = replay_cur;
+
+    if(replay_idx == t->count) {
+        ESP_LOGI(TAG, "Pass %u replayed in %u ms", ++replay_pass, elapsed);
+        replay_running = false;
+#if CONFIG_TOUCH_TRACE_REPLAY_LOOP
+        replay_idx = 0;
+#endif
+        return false;
+    }
+
+    return elapsed >= replay_due;
+}
+
+#endif /*TOUCH_TRACE_RECORD*/
+
+#endif /*TOUCH_TRACE_ENABLED*/
@@ -0,0 +1,64 @@
+/**
+ * @file touch_trace.h
+ *
+ * Touch trace record and replay. The recorder stores the timestamped
+ * samples of touch_driver_read() in NVS, the replay driver feeds a stored
+ * trace back to LVGL instead of the touch controller, so that the same
+ * session can be rerun on every build.
+ */
+
+#ifndef TOUCH_TRACE_H
+#define TOUCH_TRACE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "sdkconfig.h"
+#include "esp_err.h"
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TOUCH_TRACE_RECORD      CONFIG_TOUCH_TRACE_RECORD
+#define TOUCH_TRACE_REPLAY      CONFIG_TOUCH_TRACE_REPLAY
+#define TOUCH_TRACE_ENABLED     (TOUCH_TRACE_RECORD || TOUCH_TRACE_REPLAY)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* One sample as stored in the trace (6 bytes) */
+typedef struct {
+    uint16_t dt;            /* [ms] since the previous sample, TOUCH_TRACE_PRESSED set while pressed */
+    int16_t x;
+    int16_t y;
+} touch_trace_event_t;
+
+#define TOUCH_TRACE_PRESSED     0x8000
+#define TOUCH_TRACE_DT_MAX      0x7FFF
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void touch_trace_init(void);
+bool touch_trace_read(lv_indev_drv_t * drv, lv_indev_data_t * data);
+int64_t touch_trace_get_sample_time(void);
+esp_err_t touch_trace_save(void);
+esp_err_t touch_trace_load(const void * blob, size_t len);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*TOUCH_TRACE_H*/